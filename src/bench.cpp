@@ -0,0 +1,406 @@
+/*
+bench.cpp
+Measures how fast the simulator itself runs: host nanoseconds per simulated instruction for e20Sim, and
+nanoseconds per access for every cache engine. Results can be saved as JSON and compared with an earlier run.
+
+Build: g++ -O2 -std=c++17 -o bench src/bench.cpp
+*/
+
+#define E20_NO_MAIN
+#include "simcache.cpp"
+
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <dirent.h>
+
+/**
+ * @brief The null_buffer class swallows the simulator log while a benchmark runs, so the terminal does not
+ * slow the measurement down.
+ */
+class null_buffer : public streambuf
+{
+protected:
+    int overflow(int c) override
+    {
+        return c;
+    }
+};
+
+/**
+ * @brief One benchmark result: its name, how many instructions or accesses it ran, and the host nanoseconds
+ * per instruction or access.
+ */
+struct bench_result
+{
+    string name;
+    long long ops;
+    double nsPerOp;
+};
+
+/**
+ * @brief Returns the host time in nanoseconds.
+ * @return double nanoseconds.
+ */
+double now_ns()
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// E20 instruction encodings used by the synthetic programs.
+unsigned enc_three(unsigned regA, unsigned regB, unsigned regDst, unsigned funct)
+{
+    return (regA << 10) | (regB << 7) | (regDst << 4) | funct;
+}
+
+unsigned enc_two(unsigned opcode, unsigned regA, unsigned regB, int imm)
+{
+    return (opcode << 13) | (regA << 10) | (regB << 7) | (imm & 127);
+}
+
+unsigned enc_jump(unsigned opcode, unsigned target)
+{
+    return (opcode << 13) | (target & 8191);
+}
+
+/**
+ * @brief Appends the instructions that set a register to a small value doubled the given number of times.
+ * @param prog The program.
+ * @param reg The register.
+ * @param base The starting value, at most 63.
+ * @param doublings How many times the value is doubled.
+ */
+void emit_constant(vector<unsigned> &prog, unsigned reg, int base, int doublings)
+{
+    prog.push_back(enc_two(0b001, 0, reg, base)); // movi $reg,base
+    for (int i = 0; i < doublings; i++)
+        prog.push_back(enc_three(reg, reg, reg, 0)); // add $reg,$reg,$reg
+}
+
+/**
+ * @brief Generates a loop of about seven million instructions over a data region above the code: every
+ * iteration loads, adds, stores, and moves the pointer by three cells.
+ * @return vector<unsigned> the program image.
+ */
+vector<unsigned> synthetic_loop()
+{
+    vector<unsigned> prog;
+
+    emit_constant(prog, 6, 63, 4); // $6 = 1008 inner iterations
+    emit_constant(prog, 5, 63, 4); // $5 = 1008 outer iterations
+    emit_constant(prog, 1, 32, 7); // $1 = 4096 data pointer
+
+    unsigned body = prog.size();
+    prog.push_back(enc_two(0b100, 1, 2, 0));   // lw $2,0($1)
+    prog.push_back(enc_three(3, 2, 3, 0));     // add $3,$3,$2
+    prog.push_back(enc_two(0b101, 1, 3, 1));   // sw $3,1($1)
+    prog.push_back(enc_two(0b001, 1, 1, 3));   // addi $1,$1,3
+    prog.push_back(enc_two(0b001, 7, 7, 1));   // addi $7,$7,1
+    prog.push_back(enc_two(0b110, 7, 6, 1));   // jeq $7,$6,next
+    prog.push_back(enc_jump(0b010, body));     // j body
+
+    prog.push_back(enc_two(0b001, 0, 7, 0));   // next: movi $7,0
+    emit_constant(prog, 1, 32, 7);             // rewind the data pointer
+    prog.push_back(enc_two(0b001, 4, 4, 1));   // addi $4,$4,1
+    prog.push_back(enc_two(0b110, 4, 5, 1));   // jeq $4,$5,halt
+    prog.push_back(enc_jump(0b010, body));     // j body
+    prog.push_back(enc_jump(0b010, prog.size())); // halt
+    return prog;
+}
+
+/**
+ * @brief Generates a straight-line program that fills most of the memory with a mix of arithmetic, loads
+ * and stores, so the code footprint is large.
+ * @return vector<unsigned> the program image.
+ */
+vector<unsigned> synthetic_straight()
+{
+    vector<unsigned> prog;
+    unsigned seed = 12345;
+
+    emit_constant(prog, 1, 63, 7); // $1 = 8064, data above the code
+
+    while (prog.size() < 8000)
+    {
+        seed = seed * 1103515245 + 12345;
+        unsigned reg = 2 + (seed >> 16) % 6;
+        switch ((seed >> 8) % 4)
+        {
+        case 0:
+            prog.push_back(enc_three(reg, 2 + reg % 6, reg, 0)); // add
+            break;
+        case 1:
+            prog.push_back(enc_two(0b001, reg, reg, (seed >> 20) % 64)); // addi
+            break;
+        case 2:
+            prog.push_back(enc_two(0b100, 1, reg, (seed >> 20) % 64)); // lw
+            break;
+        default:
+            prog.push_back(enc_two(0b101, 1, reg, (seed >> 20) % 64)); // sw
+            break;
+        }
+    }
+    prog.push_back(enc_jump(0b010, prog.size())); // halt
+    return prog;
+}
+
+/**
+ * @brief Loads a machine code file into a program image.
+ * @param path The .bin file.
+ * @param image The program image.
+ * @return true if the file was read.
+ */
+bool load_image(const string &path, vector<unsigned> &image)
+{
+    ifstream f(path);
+    if (!f.is_open())
+        return false;
+
+    e20_processor scratch;
+    load_machine_code(f, scratch.memory);
+    image.assign(scratch.memory, scratch.memory + MEM_SIZE);
+    return true;
+}
+
+/**
+ * @brief Tells if a program image holds a setseg, which throws outside extended mode. A data word that looks
+ * like one only turns extended mode on, which the other programs don't notice.
+ * @param image The program image.
+ * @return true if the program should run in extended mode.
+ */
+bool uses_setseg(const vector<unsigned> &image)
+{
+    for (unsigned word : image)
+    {
+        if ((word >> 13) == 0 && (word & 15) == 0b1001)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Runs a program to completion again and again for at least minTime nanoseconds, and measures the
+ * nanoseconds per simulated instruction.
+ * @param name The benchmark name.
+ * @param image The program image.
+ * @param config The cache configuration, 3 or 6 parts as for --cache.
+ * @param minTime Minimum measuring time in nanoseconds.
+ * @return bench_result the result.
+ */
+bench_result bench_program(const string &name, const vector<unsigned> &image, const vector<int> &config, double minTime)
+{
+    long long instructions = 0;
+    double elapsed = 0;
+    bool isTwoCache = config.size() == 6;
+    bool extended = uses_setseg(image);
+
+    while (elapsed < minTime)
+    {
+        e20_processor proc;
+        copy(image.begin(), image.end(), proc.memory);
+        proc.extended = extended;
+
+        cache l1(config[0] / (config[2] * config[1]), config[2], config[1]);
+        cache l2(isTwoCache ? config[3] / (config[5] * config[4]) : 1, isTwoCache ? config[5] : 1, isTwoCache ? config[4] : 1);
+        sim_context ctx(l1, l2, isTwoCache);
+
+        double start = now_ns();
+        do
+        {
+            instructions++;
+        } while (e20Step(proc, ctx) == false);
+        elapsed += now_ns() - start;
+    }
+
+    return {name, instructions, elapsed / instructions};
+}
+
+/**
+ * @brief Measures the nanoseconds per access of one cache engine and configuration over a pattern.
+ * @param name The benchmark name.
+ * @param lines Lines of the cache.
+ * @param blockSize Blocksize of the cache.
+ * @param assoc Associativity, 0 for the fully_associated engine.
+ * @param addresses The access pattern.
+ * @return bench_result the result.
+ */
+bench_result bench_cache(const string &name, int lines, int blockSize, int assoc, const vector<long long> &addresses)
+{
+    cache c(lines, blockSize, assoc);
+
+    double start = now_ns();
+    for (long long address : addresses)
+    {
+        c.config_Cache(address);
+        c.cacheType();
+    }
+    double elapsed = now_ns() - start;
+
+    return {name, (long long)addresses.size(), elapsed / addresses.size()};
+}
+
+/**
+ * @brief Writes the results as JSON.
+ * @param path The output file.
+ * @param results The benchmark results.
+ */
+void write_json(const string &path, const vector<bench_result> &results)
+{
+    ofstream out(path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        out << "    {\"name\": \"" << results[i].name << "\", \"ops\": " << results[i].ops
+            << ", \"ns_per_op\": " << fixed << setprecision(3) << results[i].nsPerOp << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+/**
+ * @brief Reads the results of an earlier run written by write_json.
+ * @param path The JSON file.
+ * @return map<string, double> nanoseconds per op by benchmark name.
+ */
+map<string, double> read_json(const string &path)
+{
+    map<string, double> results;
+    ifstream in(path);
+    regex entry_re("\"name\": \"([^\"]+)\", \"ops\": \\d+, \"ns_per_op\": ([0-9.]+)");
+    string line;
+    while (getline(in, line))
+    {
+        smatch sm;
+        if (regex_search(line, sm, entry_re))
+            results[sm[1]] = stod(sm[2]);
+    }
+    return results;
+}
+
+int main(int argc, char *argv[])
+{
+    string programs = "tests-cache", out_path, compare_path;
+    long long accesses = 1 << 20;
+    double threshold = 10.0, minTime = 2e8;
+    bool arg_error = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg(argv[i]);
+        if (i + 1 >= argc)
+            arg_error = true;
+        else if (arg == "--programs")
+            programs = argv[++i];
+        else if (arg == "--out")
+            out_path = argv[++i];
+        else if (arg == "--compare")
+            compare_path = argv[++i];
+        else if (arg == "--threshold")
+            threshold = stod(argv[++i]);
+        else if (arg == "--accesses")
+            accesses = stoll(argv[++i]);
+        else if (arg == "--min-time")
+            minTime = stod(argv[++i]) * 1e6;
+        else
+            arg_error = true;
+    }
+    if (arg_error)
+    {
+        cerr << "usage " << argv[0] << " [--programs DIR] [--out FILE] [--compare FILE] [--threshold PCT]" << endl
+             << "       [--accesses N] [--min-time MS]" << endl
+             << endl;
+        cerr << "Benchmark the E20 cache simulator" << endl
+             << endl;
+        cerr << "  --programs DIR   Directory of .bin programs to run (default tests-cache)" << endl;
+        cerr << "  --out FILE       Save the results as JSON" << endl;
+        cerr << "  --compare FILE   Compare with the JSON results of an earlier run" << endl;
+        cerr << "  --threshold PCT  Slowdown reported as a regression (default 10)" << endl;
+        cerr << "  --accesses N     Accesses per cache benchmark (default 1048576)" << endl;
+        cerr << "  --min-time MS    Minimum time per program benchmark (default 200)" << endl;
+        return 1;
+    }
+
+    vector<bench_result> results;
+    null_buffer sink;
+    streambuf *console = cout.rdbuf(&sink); // the simulator log is not part of the report.
+
+    /* ISA core: the test programs and the synthetic programs */
+    map<string, vector<unsigned>> images;
+    DIR *dir = opendir(programs.c_str());
+    for (dirent *ent = dir ? readdir(dir) : nullptr; ent != nullptr; ent = readdir(dir))
+    {
+        string file = ent->d_name;
+        if (file.size() > 4 && file.substr(file.size() - 4) == ".bin")
+            load_image(programs + "/" + file, images[file.substr(0, file.size() - 4)]);
+    }
+    if (dir)
+        closedir(dir);
+    images["synthetic-loop"] = synthetic_loop();
+    images["synthetic-straight"] = synthetic_straight();
+
+    vector<pair<string, vector<int>>> configs = {{"l1", {64, 2, 4}}, {"l1l2", {64, 2, 4, 512, 4, 8}}};
+    for (auto &image : images)
+    {
+        image.second.resize(MEM_SIZE, 0);
+        for (auto &config : configs)
+            results.push_back(bench_program("sim/" + image.first + "/" + config.first, image.second, config.second, minTime));
+    }
+
+    /* cache engines over random, streaming and strided addresses */
+    map<string, vector<long long>> patterns;
+    unsigned seed = 2214;
+    for (long long i = 0; i < accesses; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        patterns["random"].push_back((seed >> 8) & 0xFFFF);
+        patterns["stream"].push_back(i & 0xFFFF);
+        patterns["stride"].push_back((i * 64) & 0xFFFF);
+    }
+
+    const int cacheSize = 4096; // cells, tag storage excluded.
+    for (auto &pattern : patterns)
+    {
+        for (int blockSize = 1; blockSize <= 64; blockSize *= 2)
+        {
+            for (int assoc = 1; assoc <= 16; assoc *= 2)
+            {
+                string engine = (assoc == 1) ? "direct" : "n_associated";
+                string name = "cache/" + engine + "/a" + to_string(assoc) + "/b" + to_string(blockSize) + "/" + pattern.first;
+                results.push_back(bench_cache(name, cacheSize / (blockSize * assoc), blockSize, assoc, pattern.second));
+            }
+            string name = "cache/fully_associated/b" + to_string(blockSize) + "/" + pattern.first;
+            results.push_back(bench_cache(name, 1, blockSize, 0, pattern.second));
+        }
+    }
+
+    cout.rdbuf(console);
+
+    map<string, double> baseline;
+    if (compare_path.size() > 0)
+        baseline = read_json(compare_path);
+
+    int regressions = 0;
+    for (bench_result &r : results)
+    {
+        cout << left << setw(44) << r.name << right << setw(10) << fixed << setprecision(2) << r.nsPerOp << " ns/op";
+        if (baseline.count(r.name) > 0)
+        {
+            double change = 100.0 * (r.nsPerOp - baseline[r.name]) / baseline[r.name];
+            cout << setw(9) << showpos << change << noshowpos << "%";
+            if (change > threshold)
+            {
+                cout << "  REGRESSION";
+                regressions++;
+            }
+        }
+        cout << endl;
+    }
+
+    if (out_path.size() > 0)
+        write_json(out_path, results);
+
+    if (compare_path.size() > 0)
+        cout << regressions << " regressions over " << threshold << "%" << endl;
+
+    return (regressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,431 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include <streambuf>
+
+using namespace std;
+
+/*
+    The binary log holds everything a run prints, in far fewer bytes than the text. A log entry packs its kind,
+    cache name, and status into one header byte, followed by varints of the line and of the pc and the address
+    as zigzag deltas from the previous entry. Names and statuses are numbered as they first appear, with a
+    definition record before first use. Other output lines are stored as text records.
+
+    Records are grouped in blocks of a fixed number of records. The deltas restart at the start of every block,
+    so decoding can begin at any block. The footer holds the name and status tables and the index of the
+    blocks, and the last 8 bytes of the file give the offset of the footer.
+
+    header byte: bits 0-1 record kind; for a log entry bits 2-4 the name and bits 5-7 the status, 7 meaning
+    the number follows as a varint.
+*/
+
+/**
+ * @brief The kinds of binary log records.
+ */
+enum binlog_kind
+{
+    BL_ENTRY,  // a log entry.
+    BL_TEXT,   // raw output text.
+    BL_DEFINE, // a name or status definition.
+    BL_END     // the end of the records, the footer follows.
+};
+
+/**
+ * @brief A decoded log record.
+ */
+struct binlog_record
+{
+    binlog_kind kind;
+    string name, status; // log entry.
+    int pc, line;
+    long long addr;
+    string text;         // text record.
+};
+
+/**
+ * @brief Appends a varint to a buffer, 7 bits per byte with the high bit set on all but the last.
+ */
+inline void put_varint(string &buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer += char((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buffer += char(value);
+}
+
+/**
+ * @brief Maps a signed delta to an unsigned value that is small when the delta is small either way.
+ */
+inline uint64_t zigzag(long long value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+/**
+ * @brief Reverses zigzag.
+ */
+inline long long unzigzag(uint64_t value)
+{
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+/**
+ * @brief The binlog_writer class writes the binary log. As a streambuf it takes the text the run prints and
+ * stores it as text records, while log entries come in through entry().
+ */
+class binlog_writer : public streambuf
+{
+
+public:
+    ostream &file;
+    long long blockRecords;       // records per block.
+    long long records;            // records written so far.
+    long long offset;             // bytes written so far.
+    long long prevPc, prevAddr;   // the previous entry of the block.
+    unordered_map<string, int> nameIds, statusIds;
+    vector<string> names, statuses;
+    vector<pair<long long, long long>> index; // file offset and first record of every block.
+    string buffer;                // bytes not written to the file yet.
+    string pending;               // text not ended by a newline yet.
+
+    /**
+     * @brief The binlog writer constructor writes the file header.
+     * @param out the file.
+     * @param block records per block.
+     */
+    binlog_writer(ostream &out, long long block) : file(out)
+    {
+        blockRecords = block;
+        records = offset = 0;
+        prevPc = prevAddr = 0;
+        buffer = "E20L";
+        buffer += char(1); // version.
+        put_varint(buffer, blockRecords);
+    }
+
+    /**
+     * @brief The start_record function starts a new block every blockRecords records.
+     */
+    void start_record()
+    {
+        if (records % blockRecords == 0)
+        {
+            index.push_back({offset + (long long)buffer.size(), records});
+            prevPc = prevAddr = 0;
+        }
+        records++;
+
+        if (buffer.size() >= 65536)
+            flush_buffer();
+    }
+
+    /**
+     * @brief The id function numbers a name or status, writing its definition the first time.
+     * @param ids the numbers given so far.
+     * @param table the strings numbered so far.
+     * @param which 0 for a name, 1 for a status.
+     * @param s the name or status.
+     * @return int its number.
+     */
+    int id(unordered_map<string, int> &ids, vector<string> &table, int which, const string &s)
+    {
+        auto it = ids.find(s);
+        if (it != ids.end())
+            return it->second;
+
+        int n = table.size();
+        ids[s] = n;
+        table.push_back(s);
+        buffer += char(BL_DEFINE);
+        buffer += char(which);
+        put_varint(buffer, n);
+        put_varint(buffer, s.size());
+        buffer += s;
+        return n;
+    }
+
+    /**
+     * @brief The entry function writes a log entry.
+     */
+    void entry(const string &name, const string &status, int pc, long long addr, int line)
+    {
+        flush_text();
+        int nameId = id(nameIds, names, 0, name);
+        int statusId = id(statusIds, statuses, 1, status);
+        start_record();
+
+        buffer += char(BL_ENTRY | (min(nameId, 7) << 2) | (min(statusId, 7) << 5));
+        if (nameId >= 7)
+            put_varint(buffer, nameId);
+        if (statusId >= 7)
+            put_varint(buffer, statusId);
+        put_varint(buffer, line);
+        put_varint(buffer, zigzag(pc - prevPc));
+        put_varint(buffer, zigzag(addr - prevAddr));
+        prevPc = pc;
+        prevAddr = addr;
+    }
+
+    /**
+     * @brief The text function writes raw output text.
+     */
+    void text(const string &s)
+    {
+        start_record();
+        buffer += char(BL_TEXT);
+        put_varint(buffer, s.size());
+        buffer += s;
+    }
+
+    /**
+     * @brief The flush_text function writes the text printed so far, even if it does not end a line.
+     */
+    void flush_text()
+    {
+        if (pending.size() > 0)
+        {
+            text(pending);
+            pending.clear();
+        }
+    }
+
+    /**
+     * @brief The flush_buffer function writes the buffered bytes to the file.
+     */
+    void flush_buffer()
+    {
+        file.write(buffer.data(), buffer.size());
+        offset += buffer.size();
+        buffer.clear();
+    }
+
+    /**
+     * @brief The close function writes the footer: the tables, the block index, and the offset of the footer.
+     */
+    void close()
+    {
+        flush_text();
+        long long footer = offset + buffer.size();
+        buffer += char(BL_END);
+
+        for (vector<string> *table : {&names, &statuses})
+        {
+            put_varint(buffer, table->size());
+            for (const string &s : *table)
+            {
+                put_varint(buffer, s.size());
+                buffer += s;
+            }
+        }
+
+        put_varint(buffer, records);
+        put_varint(buffer, index.size());
+        for (auto &block : index)
+        {
+            put_varint(buffer, block.first);
+            put_varint(buffer, block.second);
+        }
+
+        for (int i = 0; i < 8; i++)
+            buffer += char((uint64_t)footer >> (8 * i));
+        flush_buffer();
+        file.flush();
+    }
+
+protected:
+    int overflow(int c) override
+    {
+        if (c != EOF)
+        {
+            pending += char(c);
+            if (c == '\n')
+                flush_text();
+        }
+        return c;
+    }
+
+    streamsize xsputn(const char *s, streamsize n) override
+    {
+        for (streamsize i = 0; i < n; i++)
+            overflow((unsigned char)s[i]);
+        return n;
+    }
+};
+
+/**
+ * @brief The binlog_reader class decodes a binary log as a stream, or from any block of a file when it can
+ * seek.
+ */
+class binlog_reader
+{
+
+public:
+    istream &file;
+    long long blockRecords;
+    long long record;             // number of the next record.
+    long long prevPc, prevAddr;
+    vector<string> names, statuses;
+    vector<pair<long long, long long>> index;
+    bool ok;                      // false once the header or a record is malformed.
+
+    /**
+     * @brief The binlog reader constructor reads the file header.
+     * @param in the file.
+     */
+    binlog_reader(istream &in) : file(in)
+    {
+        char magic[5];
+        ok = (bool)file.read(magic, 5) && string(magic, 4) == "E20L" && magic[4] == 1;
+        uint64_t block = 0;
+        ok = ok && get_varint(block) && block > 0;
+        blockRecords = block;
+        record = 0;
+        prevPc = prevAddr = 0;
+    }
+
+    /**
+     * @brief Reads a varint.
+     */
+    bool get_varint(uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int c = file.get();
+            if (c == EOF)
+                return false;
+            value |= (uint64_t)(c & 0x7F) << shift;
+            if ((c & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reads a varint length followed by that many bytes.
+     */
+    bool get_string(string &s)
+    {
+        uint64_t size;
+        if (!get_varint(size) || size > (1u << 30))
+            return false;
+        s.resize(size);
+        return size == 0 || (bool)file.read(&s[0], size);
+    }
+
+    /**
+     * @brief Sets a name or status, growing the table as needed.
+     */
+    void define(vector<string> &table, uint64_t n, const string &s)
+    {
+        if (table.size() <= n)
+            table.resize(n + 1);
+        table[n] = s;
+    }
+
+    /**
+     * @brief The next function decodes the next record, handling definitions on the way.
+     * @param r the record.
+     * @return false at the end of the records or if the log is malformed.
+     */
+    bool next(binlog_record &r)
+    {
+        while (ok)
+        {
+            int header = file.get();
+            if (header == EOF || (header & 3) == BL_END)
+                return false;
+
+            if ((header & 3) == BL_DEFINE)
+            {
+                int which = file.get();
+                uint64_t n;
+                string s;
+                ok = which != EOF && get_varint(n) && n < (1u << 20) && get_string(s);
+                if (ok)
+                    define(which == 0 ? names : statuses, n, s);
+                continue;
+            }
+
+            if (record % blockRecords == 0)
+                prevPc = prevAddr = 0;
+            record++;
+            r.kind = (binlog_kind)(header & 3);
+
+            if (r.kind == BL_TEXT)
+            {
+                ok = get_string(r.text);
+                return ok;
+            }
+
+            uint64_t nameId = (header >> 2) & 7, statusId = (header >> 5) & 7, line, pc, addr;
+            ok = (nameId < 7 || get_varint(nameId)) && (statusId < 7 || get_varint(statusId))
+                 && get_varint(line) && get_varint(pc) && get_varint(addr)
+                 && nameId < names.size() && statusId < statuses.size();
+            if (!ok)
+                return false;
+
+            r.name = names[nameId];
+            r.status = statuses[statusId];
+            r.line = line;
+            prevPc += unzigzag(pc);
+            prevAddr += unzigzag(addr);
+            r.pc = prevPc;
+            r.addr = prevAddr;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief The seek function reads the footer and moves to the block holding a record, so that the
+     * following next() calls return the records of that block. The caller skips to the record itself.
+     * @param target the record number.
+     * @return false if the file has no footer or the record does not exist.
+     */
+    bool seek(long long target)
+    {
+        file.seekg(-8, ios::end);
+        uint64_t footer = 0;
+        for (int i = 0; i < 8; i++)
+            footer |= (uint64_t)(unsigned char)file.get() << (8 * i);
+        if (!file || !file.seekg(footer) || file.get() != BL_END)
+            return ok = false;
+
+        for (vector<string> *table : {&names, &statuses})
+        {
+            uint64_t count;
+            ok = ok && get_varint(count) && count < (1u << 20);
+            for (uint64_t n = 0; ok && n < count; n++)
+            {
+                string s;
+                ok = get_string(s);
+                define(*table, n, s);
+            }
+        }
+
+        uint64_t total, blocks;
+        ok = ok && get_varint(total) && get_varint(blocks);
+        index.clear();
+        for (uint64_t b = 0; ok && b < blocks; b++)
+        {
+            uint64_t at = 0, first = 0;
+            ok = get_varint(at) && get_varint(first);
+            index.push_back({(long long)at, (long long)first});
+        }
+        if (!ok || target < 0 || target >= (long long)total)
+            return false;
+
+        size_t b = target / blockRecords;
+        file.clear();
+        file.seekg(index[b].first);
+        record = index[b].second;
+        return (bool)file;
+    }
+};
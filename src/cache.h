@@ -1,24 +1,274 @@
 #pragma once
 #include <vector>
 #include <list>
+#include <deque>
 #include <unordered_map>
 #include <cmath>
+#include <algorithm>
+#include "hooks.h"
 
 using namespace std;
 
+template <class Observer>
+class basic_cache;
+
+// The cache type of the simulator, its observer policy is chosen at compile time in hooks.h.
+typedef basic_cache<E20_CACHE_OBSERVER> cache;
+
+/**
+ * @brief The set_sampler class picks a subset of the sets of a cache to simulate, every Nth set or a hashed
+ * sample of them, and counts the accesses and misses of every sampled set so the totals can be scaled back
+ * up with a confidence interval. For validation it can also own a full copy of the cache that sees every
+ * access.
+ */
+class set_sampler
+{
+
+public:
+    int every;                     // one in every sets is sampled.
+    bool hashed;                   // pick the sets by a hash of the set number instead of its stride.
+    int numSets, sampledSets;      // sets of the cache, and how many of them are sampled.
+    vector<long long> setAccesses; // accesses of every set, only sampled sets are counted.
+    vector<long long> setMisses;   // misses of every set, only sampled sets are counted.
+    cache *full;                   // full model for validation, nullptr when not validating.
+
+    /**
+     * @brief The set sampler constructor chooses the sampled sets.
+     * @param sets The number of sets of the cache.
+     * @param sampleEvery One in every sets is sampled.
+     * @param hash Pick the sets by a hash of the set number.
+     */
+    set_sampler(int sets, int sampleEvery, bool hash)
+    {
+        every = sampleEvery;
+        hashed = hash;
+        numSets = sets;
+        setAccesses.assign(sets, 0);
+        setMisses.assign(sets, 0);
+        full = nullptr;
+
+        sampledSets = 0;
+        for (int set = 0; set < sets; set++)
+        {
+            if (sampled(set))
+                sampledSets++;
+        }
+    }
+
+    /**
+     * @brief The sampled function checks if a set is part of the sample.
+     * @param set The set number.
+     * @return true if the set is simulated.
+     */
+    bool sampled(int set)
+    {
+        unsigned key = hashed ? ((unsigned)set * 2654435761u) >> 16 : (unsigned)set;
+        return key % every == 0;
+    }
+
+    /**
+     * @brief The record function counts an access to a sampled set.
+     * @param set The set number.
+     * @param hit If the access hit.
+     */
+    void record(int set, bool hit)
+    {
+        setAccesses[set]++;
+        if (!hit)
+            setMisses[set]++;
+    }
+};
+
+/**
+ * @brief The way_predictor class models way prediction: before comparing the tags of a set, the cache guesses
+ * the block an access will hit and reads only that way. A hit on the guessed block takes one probe, any other
+ * hit takes a second probe of the remaining ways. The guess is either the most recently used block of the set
+ * or the block the same instruction accessed last time.
+ */
+class way_predictor
+{
+
+public:
+    size_t const static PC_ENTRIES = 1024; // entries of the per-pc table, indexed by the low bits of the pc.
+    bool byPc;                    // predict by the pc of the access instead of the most recently used block.
+    vector<long long> lastBlock;  // blockID last accessed by the instruction of every entry, -1 if none.
+    long long firstProbe;         // hits on the predicted block.
+    long long secondProbe;        // hits on another block.
+    long long misses;             // misses, every way was probed.
+
+    /**
+     * @brief The way predictor constructor starts with nothing predicted.
+     * @param pc Predict by pc instead of the most recently used block.
+     */
+    way_predictor(bool pc)
+    {
+        byPc = pc;
+        lastBlock.assign(pc ? PC_ENTRIES : 0, -1);
+        firstProbe = secondProbe = misses = 0;
+    }
+
+    /**
+     * @brief The predict function guesses the block an access will hit.
+     * @param pc The pc of the access.
+     * @param mruBlock The blockID of the most recently used block of the set, -1 if the set is empty.
+     * @return long long the predicted blockID.
+     */
+    long long predict(int pc, long long mruBlock)
+    {
+        return byPc ? lastBlock[pc % PC_ENTRIES] : mruBlock;
+    }
+
+    /**
+     * @brief The record function counts the outcome of a prediction and trains the per-pc table.
+     * @param pc The pc of the access.
+     * @param predicted The predicted blockID.
+     * @param blockID The blockID accessed.
+     * @param hit If the access hit.
+     */
+    void record(int pc, long long predicted, long long blockID, bool hit)
+    {
+        if (!hit)
+            misses++;
+        else if (predicted == blockID)
+            firstProbe++;
+        else
+            secondProbe++;
+
+        if (byPc)
+            lastBlock[pc % PC_ENTRIES] = blockID;
+    }
+};
+
+/**
+ * @brief The set_dueling class picks the insertion policy of an associative cache by dynamic insertion (DIP).
+ * A few leader sets always insert at the most recently used end (LRU), a few always use bimodal insertion
+ * (BIP), which puts a new block at the least recently used end except once every BIP_THROTTLE fills. A miss in
+ * an LRU leader counts up a saturating policy selector, a miss in a BIP leader counts it down, and every
+ * other set follows BIP while the selector is in its upper half. BIP keeps part of a working set too big for
+ * the cache instead of cycling the whole of it through.
+ */
+class set_dueling
+{
+
+public:
+    int const static PSEL_MAX = 1023;       // the 10 bit policy selector.
+    int const static BIP_THROTTLE = 32;     // one in this many BIP fills goes to the most recently used end.
+    int const static TRAJECTORY = 64;       // selector samples kept.
+    int period;                   // one LRU and one BIP leader in every period sets.
+    int psel, pselMin, pselMax;   // the policy selector and its range over the run.
+    long long bipFills;           // fills under BIP, for the throttle.
+    long long accesses[2];        // accesses of sets under LRU and under BIP.
+    long long leaderMisses[2];    // misses of the LRU and of the BIP leaders.
+    vector<int> trajectory;       // the selector every interval accesses.
+    long long interval;           // accesses between two samples, doubled when the trajectory fills up.
+    long long sinceSample;        // accesses since the last sample.
+
+    /**
+     * @brief The set dueling constructor spreads the leaders over the sets, with the selector halfway.
+     * @param numSets number of sets of the cache, at least two.
+     */
+    set_dueling(int numSets)
+    {
+        period = min(numSets, 32);
+        psel = pselMin = pselMax = PSEL_MAX / 2; // the other sets start with LRU.
+        bipFills = 0;
+        accesses[0] = accesses[1] = 0;
+        leaderMisses[0] = leaderMisses[1] = 0;
+        interval = 1;
+        sinceSample = 0;
+    }
+
+    /**
+     * @brief The use_bip function returns the policy of a set.
+     * @param set the set.
+     * @return true for bimodal insertion, false for LRU.
+     */
+    bool use_bip(int set)
+    {
+        int slot = set % period;
+        if (slot == 0)
+            return false;
+        if (slot == period - 1)
+            return true;
+        return psel > PSEL_MAX / 2;
+    }
+
+    /**
+     * @brief The insert_mru function tells if a BIP fill goes to the most recently used end.
+     */
+    bool insert_mru()
+    {
+        return bipFills++ % BIP_THROTTLE == 0;
+    }
+
+    /**
+     * @brief The record function counts an access and trains the selector on the misses of the leaders.
+     * @param set the set.
+     * @param bip if the set used bimodal insertion.
+     * @param hit if the access hit.
+     */
+    void record(int set, bool bip, bool hit)
+    {
+        accesses[bip]++;
+        int slot = set % period;
+        if (!hit && (slot == 0 || slot == period - 1))
+        {
+            leaderMisses[bip]++;
+            psel = bip ? max(psel - 1, 0) : min(psel + 1, PSEL_MAX);
+            pselMin = min(pselMin, psel);
+            pselMax = max(pselMax, psel);
+        }
+
+        if (++sinceSample == interval)
+        {
+            sinceSample = 0;
+            if ((int)trajectory.size() == TRAJECTORY) // keep every other sample, twice as far apart.
+            {
+                for (int i = 0; i < TRAJECTORY / 2; i++)
+                    trajectory[i] = trajectory[2 * i + 1];
+                trajectory.resize(TRAJECTORY / 2);
+                interval *= 2;
+            }
+            trajectory.push_back(psel);
+        }
+    }
+};
+
 /**
  * @brief An cache object is represented by the cache class. It contains three differnt types of configrations
  * direct-cache, n-assicated, and fully-associate. For associative caches, it uses the least-recently-used (LRU) 
- * replacement policy.
+ * replacement policy. The Observer policy receives every access, hit, miss, fill, eviction and writeback; see
+ * hooks.h.
  */
-class cache
+template <class Observer>
+class basic_cache
 {
 
 public:
     string status;              // the status if miss or hit
     vector<int> valBit;         // the valid bit for each block  
-    vector<vector<int>> blocks; // blocks cotaining the tags
-    int blockSize, line, blockID, tagVal, numLine, associate;
+    vector<vector<long long>> blocks; // blocks cotaining the tags
+    vector<vector<bool>> filled; // false for the empty ways a line starts with, parallel to blocks.
+    int blockSize, line, numLine, associate;
+    long long blockID, tagVal;  // wide enough for extended addresses
+    long long hits, misses;     // number of accesses that hit and missed
+    set_sampler *sampler;       // simulates only a sample of the sets, nullptr to simulate all of them.
+    way_predictor *predictor;   // counts way predictions of an associative cache, nullptr to skip them.
+    long long address;          // the address of the current access.
+    int pc, level, way;         // pc of the access, the cache level, and the way that hit or was filled.
+    Observer observer;          // receives the cache events.
+    bool observed;              // false for models whose events should not be reported.
+    int sectorSize;             // cells per sector, 0 when blocks are not sectored.
+    vector<vector<uint64_t>> sectorValid, sectorDirty; // sector bits of every block, parallel to blocks.
+    long long sectorMisses;     // accesses whose tag hit but whose sector was not valid.
+    long long cellsFetched;     // cells of the sectors filled from the next level.
+    long long dirtyWritebacks;  // dirty sectors written back when their block was evicted.
+    int position;               // where the block of the current access is in its line after the lookup.
+    set_dueling *dueling;       // picks LRU or bimodal insertion, nullptr to always insert as LRU.
+    vector<int> quota;          // ways of every core in each set, empty when the ways are not partitioned.
+    vector<vector<int>> owners; // the core that filled every block, -1 for none, parallel to blocks.
+    int requester;              // the core making the current access.
+    vector<long long> coreHits, coreMisses; // accesses of every core to a partitioned cache.
 
     /**
      * @brief The cache contractor initializes all blocks to zero, the block-size, the number of lines in the cache, the
@@ -27,48 +277,358 @@ public:
      * @param blockS The blocksize of the cache
      * @param assoc The associate value
      */
-    cache(int lines, int blockS, int assoc)
+    basic_cache(int lines, int blockS, int assoc)
     {
 
         valBit.assign(lines, 0);  
 
-        blocks.assign(lines, vector<int>(assoc, 0)); 
+        blocks.assign(lines, vector<long long>(max(assoc, 1), 0)); // a fully associated line starts with one block.
+        filled.assign(lines, vector<bool>(max(assoc, 1), false));
 
         status = "";
+        hits = 0;
+        misses = 0;
+        sampler = nullptr;
+        predictor = nullptr;
+        address = 0;
+        pc = 0;
+        level = 1;
+        way = 0;
+        observed = true;
+        sectorSize = 0;
+        sectorMisses = cellsFetched = dirtyWritebacks = 0;
+        position = 0;
+        dueling = nullptr;
+        requester = 0;
         blockSize = blockS;
         numLine = lines;
         associate = assoc;
     }
 
     /**
-     * @brief The config_cache methods sets the cache blockID, which line, and the tag value.
+     * @brief The reset method empties the cache and clears its counters, keeping its geometry and the
+     * memory of its blocks, so a pooled cache can serve another run.
+     */
+    void reset()
+    {
+        fill(valBit.begin(), valBit.end(), 0);
+        for (vector<long long> &set : blocks)
+            set.assign(max(associate, 1), 0);
+        for (vector<bool> &set : filled)
+            set.assign(max(associate, 1), false);
+
+        status = "";
+        hits = 0;
+        misses = 0;
+        sampler = nullptr;
+        predictor = nullptr;
+        address = 0;
+        pc = 0;
+        level = 1;
+        way = 0;
+        observed = true;
+        sectorSize = 0;
+        sectorValid.clear();
+        sectorDirty.clear();
+        sectorMisses = cellsFetched = dirtyWritebacks = 0;
+        position = 0;
+        dueling = nullptr;
+        quota.clear();
+        owners.clear();
+        requester = 0;
+        coreHits.clear();
+        coreMisses.clear();
+    }
+
+    /**
+     * @brief The set_partition method splits the ways of every set between the cores sharing the cache. A
+     * core below its quota takes a block from a core above its own, a core at its quota replaces its own
+     * least recently used block. A hit only moves its block to the most recently used end, so the blocks
+     * every core holds change with fills alone.
+     * @param ways the ways of every core, adding up to the associativity.
+     */
+    void set_partition(const vector<int> &ways)
+    {
+        quota = ways;
+        owners.assign(numLine, vector<int>(max(associate, 1), -1));
+        coreHits.assign(ways.size(), 0);
+        coreMisses.assign(ways.size(), 0);
+    }
+
+    /**
+     * @brief The occupancy function counts the blocks a core holds in a partitioned cache.
+     * @param core the core.
+     * @return long long the blocks filled by the core that are still in the cache.
+     */
+    long long occupancy(int core)
+    {
+        long long held = 0;
+        for (vector<int> &own : owners)
+            held += count(own.begin(), own.end(), core);
+        return held;
+    }
+
+    /**
+     * @brief The victim_way function returns the position of the block a fill replaces in the current line:
+     * the least recently used one, or with partitioned ways the least recently used one the requesting core
+     * may take.
+     * @return int the position in the line.
+     */
+    int victim_way()
+    {
+        if (quota.empty())
+            return 0;
+
+        vector<int> &own = owners[line];
+        bool atQuota = count(own.begin(), own.end(), requester) >= quota[requester];
+        for (size_t i = 0; i < own.size(); i++)
+        {
+            if (atQuota ? own[i] == requester
+                        : (own[i] < 0 || (own[i] != requester && count(own.begin(), own.end(), own[i]) > quota[own[i]])))
+                return i;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief The erase_way function removes a block from a line, with its sector bits and owner.
+     * @param set the line.
+     * @param i the position of the block.
+     */
+    void erase_way(int set, int i)
+    {
+        blocks[set].erase(blocks[set].begin() + i);
+        filled[set].erase(filled[set].begin() + i);
+        if (sectorSize > 0)
+        {
+            sectorValid[set].erase(sectorValid[set].begin() + i);
+            sectorDirty[set].erase(sectorDirty[set].begin() + i);
+        }
+        if (!quota.empty())
+            owners[set].erase(owners[set].begin() + i);
+    }
+
+    /**
+     * @brief The insert_way function puts a block in a line, with its sector bits and owner.
+     * @param set the line.
+     * @param i the position of the block.
+     * @param tag the tag of the block.
+     * @param valid the valid sectors of the block.
+     * @param dirty the dirty sectors of the block.
+     * @param owner the core that filled the block.
+     */
+    void insert_way(int set, int i, long long tag, uint64_t valid, uint64_t dirty, int owner)
+    {
+        blocks[set].insert(blocks[set].begin() + i, tag);
+        filled[set].insert(filled[set].begin() + i, true);
+        if (sectorSize > 0)
+        {
+            sectorValid[set].insert(sectorValid[set].begin() + i, valid);
+            sectorDirty[set].insert(sectorDirty[set].begin() + i, dirty);
+        }
+        if (!quota.empty())
+            owners[set].insert(owners[set].begin() + i, owner);
+    }
+
+    /**
+     * @brief The set_sectors method splits every block into sectors with their own valid and dirty bits. A miss
+     * then fetches only the sector of the access, and a tag hit on a sector that is not valid is a miss too.
+     * @param size cells per sector, dividing the blocksize into at most 64 sectors.
+     */
+    void set_sectors(int size)
+    {
+        sectorSize = size;
+        sectorValid.assign(numLine, vector<uint64_t>(max(associate, 1), 0));
+        sectorDirty = sectorValid;
+    }
+
+    /**
+     * @brief The sector_bit function returns the bit of the sector of the current access.
+     * @return uint64_t the sector bit.
+     */
+    uint64_t sector_bit()
+    {
+        return uint64_t(1) << ((address % blockSize) / sectorSize);
+    }
+
+    /**
+     * @brief The fill_sector function runs after a lookup of a sectored cache, on the block of the access. A tag hit on a sector that is not valid becomes a miss, and a
+     * sector that is not valid is fetched.
+     */
+    void fill_sector()
+    {
+        uint64_t &valid = sectorValid[line][position];
+        uint64_t bit = sector_bit();
+
+        if ((valid & bit) == 0)
+        {
+            if (status == "HIT")
+            {
+                status = "MISS";
+                sectorMisses++;
+            }
+            valid |= bit;
+            cellsFetched += sectorSize;
+        }
+    }
+
+    /**
+     * @brief The mark_dirty function marks the sector of the current access dirty after a store.
+     */
+    void mark_dirty()
+    {
+        if (sectorSize > 0)
+            sectorDirty[line][position] |= sector_bit();
+    }
+
+    /**
+     * @brief The write_back_sectors function writes back the dirty sectors of a block leaving the cache.
+     * @param tag The tag of the block.
+     * @param dirty The dirty sectors of the block.
+     * @param victimWay The way of the block.
+     */
+    void write_back_sectors(long long tag, uint64_t dirty, int victimWay)
+    {
+        for (int sector = 0; dirty != 0; sector++, dirty >>= 1)
+        {
+            if (dirty & 1)
+            {
+                dirtyWritebacks++;
+                emit(EV_WRITEBACK, (tag * numLine + line) * blockSize + sector * sectorSize, victimWay);
+            }
+        }
+    }
+
+    /**
+     * @brief The replace_sectors function empties the sectors of a direct or fully associated block taking a
+     * new tag, writing back the dirty sectors of the block it replaces.
+     * @param tag The tag of the replaced block, negative if there was none.
+     */
+    void replace_sectors(long long tag)
+    {
+        if (sectorSize == 0)
+            return;
+        if (tag >= 0)
+            write_back_sectors(tag, sectorDirty[line][0], 0);
+        sectorValid[line][0] = sectorDirty[line][0] = 0;
+    }
+
+    /**
+     * @brief The take_sectors function collects the sector bits of a block that hit in an associative line. The
+     * line may hold older copies of the tag, the last one is the freshest; every copy is emptied so that only
+     * the copy moved to the most recently used end keeps the bits.
+     * @param valid set to the valid sectors of the block.
+     * @param dirty set to the dirty sectors of the block.
+     */
+    void take_sectors(uint64_t &valid, uint64_t &dirty)
+    {
+        for (size_t i = 0; i < blocks[line].size(); i++)
+        {
+            if (blocks[line][i] == tagVal)
+            {
+                valid = sectorValid[line][i];
+                dirty = sectorDirty[line][i];
+                sectorValid[line][i] = sectorDirty[line][i] = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief The config_cache methods sets the cache blockID, which line, and the tag value. Integer division
+     * is used so that extended addresses keep their full precision.
      * @param address A poniter that points to a value in the cache.
      */
-    void config_Cache(int address)
+    void config_Cache(long long address)
     {
-        blockID = floor(address / blockSize);
-        line = floor(blockID % numLine);
-        tagVal = floor(blockID / numLine);
+        this->address = address;
+        blockID = address / blockSize;
+        line = blockID % numLine;
+        tagVal = blockID / numLine;
+    }
+
+    /**
+     * @brief The in_sample method checks, right after config_Cache, if the line is simulated. Accesses to
+     * sets outside the sample are dropped. When validating, the full model sees the access either way.
+     * @param address The address given to config_Cache.
+     * @return true if the access should be simulated.
+     */
+    bool in_sample(long long address)
+    {
+        if (sampler == nullptr)
+            return true;
+
+        if (sampler->full != nullptr)
+        {
+            sampler->full->config_Cache(address);
+            sampler->full->cacheType();
+        }
+        return sampler->sampled(line);
+    }
+
+    /**
+     * @brief The emit function reports an event to the observer. With a policy that is not enabled it
+     * compiles to nothing.
+     * @param kind The kind of event.
+     * @param eventAddress The address of the event.
+     * @param eventWay The way involved.
+     */
+    void emit(cache_event_kind kind, long long eventAddress, int eventWay)
+    {
+        if (Observer::enabled && observed && observer.active())
+            observer.notify(cache_event{kind, pc, eventAddress, level, line, eventWay});
+    }
+
+    /**
+     * @brief The evict function reports the block with the given tag leaving the current line.
+     * @param tag The tag of the evicted block.
+     * @param victimWay The way of the evicted block.
+     */
+    void evict(long long tag, int victimWay)
+    {
+        if (tag >= 0) // invalidated blocks have a negative tag.
+            emit(EV_EVICT, (tag * numLine + line) * blockSize, victimWay);
+    }
+
+    /**
+     * @brief The writeback function reports a store being written on to the next level.
+     */
+    void writeback()
+    {
+        emit(EV_WRITEBACK, address, way);
     }
 
     /**
      * @brief The blocks full function detects whether or not all of the blocks for a given line are occupied.
      * If it is, it pops the first entry of the first block, which is arranged from least recently used.
+     * With partitioned ways it pops the block the requesting core may replace instead. Only a filled block
+     * whose tag leaves the line is reported as evicted: not an empty way, nor a copy of a tag that stays, as
+     * the block of a hit does.
      * @param blocks the blocks of the cache
      */
-    void blocks_full(vector<vector<int>> &blocks)
+    void blocks_full(vector<vector<long long>> &blocks)
     {
         if (blocks[line].size() == associate)
         {
-            blocks[line].erase(blocks[line].begin());
+            int victim = victim_way();
+            vector<long long> &set = blocks[line];
+            long long tag = set[victim];
+            if (valBit[line] != 0 && filled[line][victim] && tag != tagVal && count(set.begin(), set.end(), tag) == 1)
+                evict(tag, victim);
+
+            if (sectorSize > 0)
+                write_back_sectors(blocks[line][victim], sectorDirty[line][victim], victim);
+            erase_way(line, victim);
         }
     }
 
     /**
-     * @brief The cache type function checks if the cache is a direct, n assoicated , or full associated.
+     * @brief The cache type function checks if the cache is a direct, n assoicated , or full associated,
+     * and counts the access as a hit or a miss.
      */
     void cacheType()
     {
+        emit(EV_ACCESS, address, 0);
+
         if (associate == 0)
             fully_associated();
 
@@ -77,6 +637,21 @@ public:
 
         else
             n_associated();
+
+        if (sectorSize > 0)
+            fill_sector();
+
+        if (status == "HIT")
+            hits++;
+        else
+            misses++;
+
+        emit((status == "HIT") ? EV_HIT : EV_MISS, address, way);
+        if (status == "MISS")
+            emit(EV_FILL, address, way);
+
+        if (sampler != nullptr)
+            sampler->record(line, status == "HIT");
     }
 
     /**
@@ -85,12 +660,14 @@ public:
      */
     void direct()
     {
+        way = 0;
 
         if (valBit.at(line) == 0) // if the vald bit has not been set
         {
             status = "MISS";
             valBit.at(line) = 1;
             blocks[line][0] = tagVal; // store the tag value to the block.
+            replace_sectors(-1);
         }
 
         else if (blocks[line][0] == tagVal) // If the block contains the tag
@@ -101,41 +678,80 @@ public:
         else // If the valid bit is not zero and the tags don't match miss with eviction.
         {
             status = "MISS";
+            evict(blocks[line][0], 0);
+            replace_sectors(blocks[line][0]);
             blocks[line][0] = tagVal;
         }
     }
 
     /**
      * @brief The n_associated cache is a configration that each line of the cache
-     * contains the number blocks by the given assication.
+     * contains the number blocks by the given assication. The most recently used block, where most hits
+     * land, is checked before scanning the line from the least recently used end.
      */
     void n_associated()
     {
+        vector<long long> &set = blocks[line];
         bool isHit = false;
+        long long predicted = -1;
+        bool bip = dueling != nullptr && dueling->use_bip(line);
+
+        if (predictor != nullptr)
+            predicted = predictor->predict(pc, valBit[line] ? set.back() * numLine + line : -1);
+
+        if (valBit[line] != 0 && set.back() == tagVal) // MRU fast path.
+        {
+            isHit = true;
+            way = associate - 1;
+        }
 
         // Checks to see if any of the blocks contain the tag vlaue.
-        for (int i = 0; i < associate && isHit == false; i++)
+        for (int i = 0; i < associate && isHit == false && valBit[line] != 0; i++)
         {
-            if (blocks[line][i] == tagVal && valBit[line] != 0) // If block contains a tag and valid bit is not zero.
+            if (set[i] == tagVal)
             {
-                isHit = true; 
-
-                status = "HIT";
-
-                blocks_full(blocks); // Removes the least resently used from if all the blocks of the line are full.
-
-                blocks[line].push_back(tagVal); // insert the tag value to the last block.
+                isHit = true;
+                way = i;
             }
-            else
-                status = "MISS";
         }
 
-        if (status == "MISS")
+        if (isHit && !quota.empty()) // move the block to the MRU end, it stays with the core that filled it.
         {
-            valBit[line] = 1;
+            status = "HIT";
+            uint64_t valid = 0, dirty = 0;
+            if (sectorSize > 0)
+                take_sectors(valid, dirty);
+            int owner = owners[line][way];
+            erase_way(line, way);
+            position = set.size();
+            insert_way(line, position, tagVal, valid, dirty, owner);
+        }
+        else if (isHit)
+        {
+            status = "HIT";
+            uint64_t valid = 0, dirty = 0;
+            if (sectorSize > 0)
+                take_sectors(valid, dirty);
+            blocks_full(blocks); // Removes the least resently used from if all the blocks of the line are full.
+            position = set.size();
+            insert_way(line, position, tagVal, valid, dirty, requester); // insert the tag value to the last block.
+        }
+        else
+        {
+            status = "MISS";
             blocks_full(blocks);            // Removes the least resently used from if all the blocks of the line are full.
-            blocks[line].push_back(tagVal); // insert the tag value to the last block.
+            valBit[line] = 1;
+            position = (bip && !dueling->insert_mru()) ? 0 : set.size(); // bimodal insertion at the LRU end.
+            insert_way(line, position, tagVal, 0, 0, requester); // insert the tag value to the last block.
+            way = (position == 0) ? 0 : associate - 1;
         }
+
+        if (predictor != nullptr)
+            predictor->record(pc, predicted, blockID, isHit);
+        if (dueling != nullptr)
+            dueling->record(line, bip, isHit);
+        if (!quota.empty())
+            (isHit ? coreHits : coreMisses)[requester]++;
     }
    
    /**
@@ -143,12 +759,14 @@ public:
     */
     void fully_associated()
     {
+        way = 0;
 
         if (valBit.at(0) == 0)  // If the valid bit is not set.
         {
             status = "MISS";
             valBit.at(line) = 1;
             blocks[line][0] = tagVal; 
+            replace_sectors(-1);
         }
         else if (blocks[line][0] == tagVal)  // If the block contains the tag.
         {
@@ -157,7 +775,113 @@ public:
         else   // If the valid bit is not zero and the tags don't match miss with eviction.s
         {  
             status = "MISS";
+            evict(blocks[line][0], 0);
+            replace_sectors(blocks[line][0]);
             blocks[line][0] = tagVal;
         }
     }
-};
\ No newline at end of file
+
+    /**
+     * @brief The probe function checks whether the block holding an address is in the cache without
+     * changing the cache, the way a snooping bus looks into another core's cache.
+     * @param address The memory address.
+     * @return true if the block is in the cache.
+     */
+    bool probe(long long address)
+    {
+        long long id = address / blockSize;
+        int set = (associate == 0) ? 0 : id % numLine;
+        long long tag = id / numLine;
+
+        if (valBit[set] == 0)
+            return false;
+
+        for (long long block : blocks[set])
+        {
+            if (block == tag)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief The invalidate function removes the block holding an address from the cache. For associative
+     * caches the freed block is marked with an impossible tag and moved to the least recently used end.
+     * @param address The memory address.
+     */
+    void invalidate(long long address)
+    {
+        long long id = address / blockSize;
+        int set = (associate == 0) ? 0 : id % numLine;
+        long long tag = id / numLine;
+
+        if (associate <= 1)
+        {
+            if (blocks[set][0] == tag)
+            {
+                valBit[set] = 0;
+                if (sectorSize > 0)
+                    sectorValid[set][0] = sectorDirty[set][0] = 0;
+            }
+            return;
+        }
+
+        vector<long long> &ways = blocks[set];
+        size_t kept = ways.size();
+        for (size_t i = ways.size(); i-- > 0;)
+        {
+            if (ways[i] == tag)
+            {
+                erase_way(set, i);
+            }
+        }
+        while (ways.size() < kept)
+            insert_way(set, 0, -1, 0, 0, -1); // tags are never negative.
+    }
+};
+
+/**
+ * @brief The cache_pool class keeps caches alive between runs. A run takes the caches it needs and they are
+ * given back all at once when it ends, so a later run with the same geometry reuses them after a reset
+ * instead of allocating its blocks again.
+ */
+class cache_pool
+{
+
+public:
+    deque<cache> caches; // every cache made so far, a deque so references stay valid.
+    vector<bool> busy;   // if the cache is taken by the current run.
+
+    /**
+     * @brief The take function returns an empty cache with the given geometry, reusing a free one if possible.
+     * @param lines Number of lines the cache contain.
+     * @param blockS The blocksize of the cache
+     * @param assoc The associate value
+     * @return cache& the cache, owned by the pool.
+     */
+    cache &take(int lines, int blockS, int assoc)
+    {
+        for (size_t i = 0; i < caches.size(); i++)
+        {
+            cache &c = caches[i];
+            if (!busy[i] && c.numLine == lines && c.blockSize == blockS && c.associate == assoc)
+            {
+                busy[i] = true;
+                c.reset();
+                return c;
+            }
+        }
+
+        caches.emplace_back(lines, blockS, assoc);
+        busy.push_back(true);
+        return caches.back();
+    }
+
+    /**
+     * @brief The release function gives back every cache taken by the run.
+     */
+    void release()
+    {
+        fill(busy.begin(), busy.end(), false);
+    }
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "cache.h"
+
+using namespace std;
+
+/**
+ * @brief The mesi_bus class is a snooping bus that keeps the private cache 1 of every core coherent with the
+ * MESI protocol. Each block is Modified, Exclusive, Shared, or Invalid in every core, and the bus counts the
+ * coherence traffic caused by reads and writes. Blocks are tracked at the blocksize of the private caches.
+ */
+class mesi_bus
+{
+
+public:
+    enum state { INVALID, SHARED, EXCLUSIVE, MODIFIED };
+
+    /**
+     * @brief The coherence entry of one block: its state in every core, and the words of the block each core
+     * touched since it got the block, used to tell false sharing from true sharing.
+     */
+    struct entry
+    {
+        vector<state> states;
+        vector<uint64_t> touched;
+    };
+
+    vector<cache *> caches;               // private cache 1 of every core.
+    int blockSize;                        // coherence unit, the blocksize of cache 1.
+    unordered_map<long long, entry> table; // blockID -> coherence entry.
+    long long busReads, busReadExs, upgrades, invalidations, falseSharing, interventions;
+
+    /**
+     * @brief The mesi bus constructor connects the private caches of every core.
+     * @param l1s private cache 1 of every core.
+     */
+    mesi_bus(const vector<cache *> &l1s)
+    {
+        caches = l1s;
+        blockSize = l1s[0]->blockSize;
+        busReads = busReadExs = upgrades = invalidations = falseSharing = interventions = 0;
+    }
+
+    /**
+     * @brief The lookup function returns the entry of the block holding an address. Blocks that a core
+     * silently evicted from its cache since the last bus transaction are Invalid for that core.
+     * @param address The memory address.
+     * @return entry& the coherence entry.
+     */
+    entry &lookup(long long address)
+    {
+        entry &e = table[address / blockSize];
+
+        if (e.states.empty())
+        {
+            e.states.assign(caches.size(), INVALID);
+            e.touched.assign(caches.size(), 0);
+        }
+
+        for (size_t core = 0; core < caches.size(); core++)
+        {
+            if (e.states[core] != INVALID && !caches[core]->probe(address))
+            {
+                e.states[core] = INVALID;
+                e.touched[core] = 0;
+            }
+        }
+        return e;
+    }
+
+    /**
+     * @brief The word function returns the bit of the accessed word within its block.
+     * @param address The memory address.
+     * @return uint64_t the word bit.
+     */
+    uint64_t word(long long address)
+    {
+        return uint64_t(1) << ((address % blockSize) & 63);
+    }
+
+    /**
+     * @brief The invalidate_others function invalidates the block in every core but the writer. An
+     * invalidation counts as false sharing when the invalidated core never touched the written word.
+     * @param e The coherence entry of the block.
+     * @param core The writing core.
+     * @param address The memory address.
+     */
+    void invalidate_others(entry &e, int core, long long address)
+    {
+        for (size_t other = 0; other < caches.size(); other++)
+        {
+            if (other == (size_t)core || e.states[other] == INVALID)
+                continue;
+
+            if (e.states[other] == MODIFIED) // the owner supplies the dirty block.
+                interventions++;
+
+            invalidations++;
+            if ((e.touched[other] & word(address)) == 0)
+                falseSharing++;
+
+            caches[other]->invalidate(address);
+            e.states[other] = INVALID;
+            e.touched[other] = 0;
+        }
+    }
+
+    /**
+     * @brief The read function snoops a load of a core. A read miss is a bus read: a Modified owner
+     * supplies the block, and the reader gets it Shared if any other core holds it, else Exclusive.
+     * @param core The reading core.
+     * @param address The memory address.
+     */
+    void read(int core, long long address)
+    {
+        entry &e = lookup(address);
+
+        if (e.states[core] == INVALID)
+        {
+            busReads++;
+            bool shared = false;
+
+            for (size_t other = 0; other < caches.size(); other++)
+            {
+                if (other == (size_t)core || e.states[other] == INVALID)
+                    continue;
+
+                if (e.states[other] == MODIFIED)
+                    interventions++;
+
+                e.states[other] = SHARED;
+                shared = true;
+            }
+            e.states[core] = shared ? SHARED : EXCLUSIVE;
+        }
+        e.touched[core] |= word(address);
+    }
+
+    /**
+     * @brief The write function snoops a store of a core. Exclusive blocks upgrade silently, Shared blocks
+     * need a bus upgrade, and a write miss is a bus read-exclusive. Both invalidate every other copy.
+     * @param core The writing core.
+     * @param address The memory address.
+     */
+    void write(int core, long long address)
+    {
+        entry &e = lookup(address);
+
+        if (e.states[core] == SHARED)
+        {
+            upgrades++;
+            invalidate_others(e, core, address);
+        }
+        else if (e.states[core] == INVALID)
+        {
+            busReadExs++;
+            invalidate_others(e, core, address);
+        }
+
+        e.states[core] = MODIFIED;
+        e.touched[core] |= word(address);
+    }
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief The dram class is the main memory behind the last cache level. Memory is split into channels and
+ * banks, each bank with a row buffer. Consecutive rows are interleaved over the channels and then the banks,
+ * so a stream of blocks stays in one row buffer until the row is used up.
+ *
+ * Every request finds its row open (a row hit, column access only), the bank closed (a row miss, activate
+ * and column access) or another row open (a conflict, precharge, activate and column access). With the
+ * open-page policy a row stays open after an access. With close-page the bank precharges right away, so
+ * there are no conflicts but also no hits. Requests to a busy bank wait for it. With the open-page policy
+ * the controller orders them FR-FCFS: a row hit is served ahead of queued requests to other rows that have
+ * not started yet, which are pushed back. Requests that were already given their completion time keep it,
+ * so the push back only delays later requests.
+ */
+class dram
+{
+
+public:
+    /**
+     * @brief A scheduled access of a bank: its row, and the cycles the bank starts and stops working on it.
+     */
+    struct access_slot
+    {
+        long long row, start, end;
+    };
+
+    /**
+     * @brief A bank: the row left open by its last access, and its accesses that are not finished yet.
+     */
+    struct bank_state
+    {
+        long long openRow;          // -1 when the bank is precharged.
+        long long freeAt;           // cycle the bank finished its last access.
+        vector<access_slot> queue;  // scheduled accesses that are not finished yet.
+    };
+
+    int channels, banks, rowSize;   // rowSize in memory cells.
+    int tCL, tRCD, tRP, tBurst;     // column access, activate, precharge, and data transfer cycles.
+    bool openPage;                  // keep rows open after an access.
+    vector<bank_state> state;       // every bank of every channel.
+    long long requests, rowHits, rowMisses, rowConflicts, reordered;
+    long long totalLatency;         // sum of the cycles from every request to its data.
+
+    /**
+     * @brief The dram constructor starts with every bank precharged.
+     * @param ch number of channels.
+     * @param bk banks per channel.
+     * @param row cells per row.
+     * @param cl column access cycles.
+     * @param rcd activate cycles.
+     * @param rp precharge cycles.
+     * @param open the open-page policy, else close-page.
+     */
+    dram(int ch, int bk, int row, int cl, int rcd, int rp, bool open)
+    {
+        channels = ch;
+        banks = bk;
+        rowSize = row;
+        tCL = cl;
+        tRCD = rcd;
+        tRP = rp;
+        tBurst = 4;
+        openPage = open;
+        state.assign(channels * banks, bank_state{-1, 0, {}});
+        requests = rowHits = rowMisses = rowConflicts = reordered = 0;
+        totalLatency = 0;
+    }
+
+    /**
+     * @brief The access function serves a read of memory that arrives at the given cycle.
+     * @param address the memory address.
+     * @param arrival the cycle the request reaches the controller.
+     * @return long long the cycles until the data is back.
+     */
+    long long access(long long address, long long arrival)
+    {
+        long long rowNumber = address / rowSize;
+        bank_state &bank = state[rowNumber % (channels * banks)]; // channel first, then bank.
+        long long row = rowNumber / (channels * banks);
+
+        while (!bank.queue.empty() && bank.queue[0].end <= arrival) // accesses finished by now.
+        {
+            bank.freeAt = bank.queue[0].end;
+            bank.queue.erase(bank.queue.begin());
+        }
+
+        requests++;
+        long long ready;
+
+        if (!openPage) // every access activates its row and precharges after.
+        {
+            long long start = max(arrival, bank.queue.empty() ? bank.freeAt : bank.queue.back().end);
+            rowMisses++;
+            bank.queue.push_back({row, start, start + tRCD + tCL + tBurst + tRP});
+            ready = start + tRCD + tCL + tBurst;
+        }
+        else if (!schedule_hit(bank, row, arrival, ready)) // FCFS behind every queued access.
+        {
+            long long start = max(arrival, bank.queue.empty() ? bank.freeAt : bank.queue.back().end);
+            long long prep = 0;
+
+            if (bank.openRow == row)
+                rowHits++;
+            else if (bank.openRow < 0)
+            {
+                rowMisses++;
+                prep = tRCD;
+            }
+            else
+            {
+                rowConflicts++;
+                prep = tRP + tRCD;
+            }
+
+            bank.queue.push_back({row, start, start + prep + tBurst});
+            bank.openRow = row;
+            ready = start + prep + tCL + tBurst;
+        }
+
+        totalLatency += ready - arrival;
+        return ready - arrival;
+    }
+
+    /**
+     * @brief The schedule_hit function serves a request as a row hit ahead of queued accesses to other rows
+     * when an access to its row is still scheduled or running and the access after it has not started.
+     * @param bank the bank.
+     * @param row the row.
+     * @param arrival the cycle the request arrives.
+     * @param ready set to the cycle the data is back.
+     * @return true if the request was served as a row hit.
+     */
+    bool schedule_hit(bank_state &bank, long long row, long long arrival, long long &ready)
+    {
+        for (size_t i = 0; i + 1 < bank.queue.size(); i++)
+        {
+            if (bank.queue[i].row != row || bank.queue[i + 1].row == row || bank.queue[i + 1].start <= arrival)
+                continue;
+
+            long long start = max(arrival, bank.queue[i].end);
+            long long end = start + tBurst;
+            long long delay = end - bank.queue[i + 1].start;
+            if (delay > 0) // the accesses behind it are pushed back.
+            {
+                for (size_t j = i + 1; j < bank.queue.size(); j++)
+                {
+                    bank.queue[j].start += delay;
+                    bank.queue[j].end += delay;
+                }
+            }
+
+            bank.queue.insert(bank.queue.begin() + i + 1, access_slot{row, start, end});
+            rowHits++;
+            reordered++;
+            ready = start + tCL + tBurst;
+            return true;
+        }
+        return false;
+    }
+};
@@ -2,12 +2,16 @@
 
 #include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include "paged_memory.h"
 
 
 /**
  * @brief An e20 processor object is represented by the e20_processor class. It has a 16-bit program counter, 
  * seven read and write (R/W) registers, and register $0 is an exclusively read (R) register with all 
  * registers being 16 bits, as well as a memory array with 8191 instructions, each instruction comprising 16 bits.
+ * In extended mode a segment register supplies the upper bits of data addresses, and every cell above the
+ * 8191 program cells lives in a sparse paged memory.
  */
 class e20_processor
 {
@@ -18,16 +22,23 @@ public:
   size_t const static MEM_SIZE = 1 << 13;  //8191
   uint16_t pc, imm;                        //unsniged 16 bits program counter and immediate value.
   unsigned *memory, *regs;                 // memory array and register array.
+  bool extended;                           // extended address mode.
+  unsigned seg;                            // segment register, upper 16 bits of an extended data address.
+  paged_memory *pages;                     // extended memory above the 8191 program cells.
+  bool ownsMemory;                         // false for cores that share another processor's memory.
 
 
   /**
    * @brief Constructer of e20 object would intilize the program counter,
    *  8191 memory cells, immediate , and all 8 registers.
    */
-  e20_processor(): memory(new unsigned[MEM_SIZE]), regs(new unsigned[NUM_REGS]){
+  e20_processor(): memory(new unsigned[MEM_SIZE]), regs(new unsigned[NUM_REGS]), pages(new paged_memory()){
     
     pc = 0;  // intilizing program counter to zero.
     imm = 0; // intilizing immediate value to zero.
+    extended = false;
+    seg = 0;
+    ownsMemory = true;
     
     // All 8191 memory cells are intilized to zero.
     for(int i=0; i < MEM_SIZE; i++){
@@ -41,6 +52,44 @@ public:
 
   }
   
+  /**
+   * @brief Constructer of an e20 core that shares the memory of another processor, used when several
+   * cores run over one memory image. Only the registers belong to the core.
+   * 
+   * @param shared the processor owning the memory.
+   */
+  e20_processor(e20_processor *shared): memory(shared->memory), regs(new unsigned[NUM_REGS]), pages(shared->pages){
+
+    pc = 0;
+    imm = 0;
+    extended = shared->extended;
+    seg = 0;
+    ownsMemory = false;
+
+    for(size_t j=0; j<NUM_REGS; j++){
+      regs[j]=0; 
+    }
+  }
+
+  /**
+   * @brief Resets the processor to the state of a new one so it can run another program without
+   * allocating its memory again.
+   */
+  void reset(){
+    pc = 0;
+    imm = 0;
+    extended = false;
+    seg = 0;
+
+    for(size_t i=0; i < MEM_SIZE; i++){
+      memory[i] =0; 
+    }
+    for(size_t j=0; j<NUM_REGS; j++){
+      regs[j]=0; 
+    }
+    pages->clear();
+  }
+
   /*
   The following 3 not inline member fuctions are large so for better perfurmance it is better to
   define them outside the e20 class.
@@ -51,6 +100,35 @@ public:
 
   void getNoRegInst(unsigned opcode);
 
+  /**
+   * @brief Calculates the data address of a lw or sw by summing $regSrcA and imm. In extended mode
+   * the 16 bit sum is the offset within the segment selected by the segment register.
+   * 
+   * @param regSrcA src regA [10:12].
+   * @param imm     sign-extended immdatidate value[6:0].
+   * @return long long the data address.
+   */
+  long long data_address(unsigned regSrcA, unsigned imm){
+    if (extended){
+      return ((long long)seg << 16) | ((regs[regSrcA] + imm) & 0xFFFF);
+    }
+    return regs[regSrcA] + imm;
+  }
+
+  /**
+   * @brief Returns the memory cell at the given data address. Without extended mode the address wraps
+   * around the 8191 cells, otherwise cells above the program memory come from the paged memory.
+   * 
+   * @param address data address.
+   * @return unsigned& the memory cell.
+   */
+  unsigned &cell(long long address){
+    if (!extended){
+      return memory[address & 8191];
+    }
+    return (address < (long long)MEM_SIZE) ? memory[address] : pages->at(address);
+  }
+
   
   /**
    * @brief Adds the value of registers $regSrcA and $regSrcB, storing the sum in $regDst. 
@@ -117,6 +195,18 @@ public:
     pc += 1; //increment program counter.
   }
   
+  /**
+   * @brief Loads the segment register with the value of $regSrcA. Only valid in extended mode,
+   * encoded as a three register instruction with the four LSB imm 1001.
+   * Symbolically: seg <- R[regSrcA].
+   * 
+   * @param regSrcA src regA [10:12].
+   */
+  void setseg(unsigned regSrcA){
+    seg = regs[regSrcA];
+    pc += 1; //increment program counter.
+  }
+
   /**
    * @brief Jumps unconditionally to the memory address in $reg.The jump destination 
    * is expressed as an absolute address. All 16 bits of the value of $reg are stored into the program counter.
@@ -151,7 +241,7 @@ public:
    */
   void lw(unsigned regSrcA, unsigned regDst, unsigned imm)
   {
-    regs[regDst] = memory[(regs[regSrcA] + imm) & 8191];
+    regs[regDst] = cell(data_address(regSrcA, imm));
     pc += 1; //increment program counter.
   }
 
@@ -165,7 +255,7 @@ public:
    */
   void sw(unsigned regSrcA, unsigned regSrcB, unsigned imm)
   {
-    memory[(regs[regSrcA] + imm) & 8191] = regs[regSrcB];
+    cell(data_address(regSrcA, imm)) = regs[regSrcB];
     pc += 1; //increment program counter.
   }
 
@@ -222,7 +312,10 @@ public:
     * when out of scope from the heap.
     */
    ~e20_processor(){
-    delete[] memory;
+    if (ownsMemory){
+      delete[] memory;
+      delete pages;
+    }
     delete[] regs;
   }
 
@@ -232,7 +325,8 @@ public:
 /**
  * @brief The getThreeRegInst not inline member fuction selects the three regeister instuction
  * based the four LSB imm.
- * Instuctions: add, sub, and, or, slt, jr.
+ * Instuctions: add, sub, and, or, slt, jr, and setseg in extended mode. Any other imm, setseg
+ * included outside extended mode, throws runtime_error rather than leaving the pc where it is.
  * @param regSrcA src regA [10:12].
  * @param regSrcB src regB [7:9].
  * @param regDst  Dst regC [4:6]. 
@@ -263,6 +357,14 @@ inline void e20_processor::getThreeRegInst(unsigned regSrcA, unsigned regSrcB, u
       jr(regSrcA);
     }
 
+    else if ((imm == 0b1001) && extended) {
+      setseg(regSrcA);
+    }
+
+    else { // setseg outside extended mode, or no instuction at all.
+      throw runtime_error("Invalid E20 Instuctions.");
+    }
+
   }
 
   /**
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The kinds of events a cache reports to its observer.
+ */
+enum cache_event_kind
+{
+    EV_ACCESS,    // a lookup starts.
+    EV_HIT,       // the block was found.
+    EV_MISS,      // the block was not found.
+    EV_FILL,      // a block was placed in the cache.
+    EV_EVICT,     // a block was removed to make room.
+    EV_WRITEBACK  // a store was written on to the next level.
+};
+
+/**
+ * @brief A cache event: what happened, the pc of the instruction, the address, the cache level, and the
+ * set and way involved. For an eviction the address is the first address of the evicted block.
+ */
+struct cache_event
+{
+    cache_event_kind kind;
+    int pc;
+    long long address;
+    int level;
+    int set;
+    int way;
+};
+
+/**
+ * @brief The null_observer policy ignores every event. Because enabled is a compile-time false, a cache
+ * built with it compiles the hooks away entirely.
+ */
+struct null_observer
+{
+    static const bool enabled = false;
+
+    bool active() const
+    {
+        return false;
+    }
+
+    void notify(const cache_event &)
+    {
+    }
+};
+
+// Functions a runtime plugin provides: one called on every event, one called at the end of the run.
+typedef void (*e20_event_fn)(const cache_event *event, void *context);
+typedef void (*e20_finish_fn)(void *context);
+
+/**
+ * @brief The plugin_api is handed to the e20_plugin_init function of every plugin loaded with --plugin, so
+ * the plugin can attach its callbacks.
+ */
+struct plugin_api
+{
+    void (*attach)(e20_event_fn onEvent, e20_finish_fn onFinish, void *context);
+};
+
+/**
+ * @brief The plugin_registry holds the callbacks of the runtime plugins.
+ */
+struct plugin_registry
+{
+    vector<e20_event_fn> events;
+    vector<e20_finish_fn> finishes;
+    vector<void *> contexts;
+
+    /**
+     * @brief Calls the finish function of every plugin, at the end of the run.
+     */
+    void finish()
+    {
+        for (size_t i = 0; i < finishes.size(); i++)
+        {
+            if (finishes[i] != nullptr)
+                finishes[i](contexts[i]);
+        }
+    }
+};
+
+/**
+ * @brief Returns the registry of the runtime plugins shared by every cache.
+ * @return plugin_registry& the registry.
+ */
+inline plugin_registry &plugins()
+{
+    static plugin_registry registry;
+    return registry;
+}
+
+/**
+ * @brief Attaches the callbacks of a plugin to the registry, the attach function of the plugin_api.
+ * @param onEvent called on every event.
+ * @param onFinish called at the end of the run, may be nullptr.
+ * @param context passed back to both callbacks.
+ */
+inline void attach_plugin(e20_event_fn onEvent, e20_finish_fn onFinish, void *context)
+{
+    plugins().events.push_back(onEvent);
+    plugins().finishes.push_back(onFinish);
+    plugins().contexts.push_back(context);
+}
+
+/**
+ * @brief The plugin_observer policy forwards every event to the runtime plugins. With no plugin loaded an
+ * event costs one check of the registry.
+ */
+struct plugin_observer
+{
+    static const bool enabled = true;
+
+    bool active() const
+    {
+        return !plugins().events.empty();
+    }
+
+    void notify(const cache_event &event)
+    {
+        plugin_registry &registry = plugins();
+        for (size_t i = 0; i < registry.events.size(); i++)
+            registry.events[i](&event, registry.contexts[i]);
+    }
+};
+
+// The observer policy of the simulator's caches, override with -DE20_CACHE_OBSERVER=<policy>.
+#ifndef E20_CACHE_OBSERVER
+#define E20_CACHE_OBSERVER plugin_observer
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @brief The paged_memory class backs the extended address space of the e20 processor. Memory is split into
+ * pages of 4K cells that are only allocated the first time they are touched, so a huge address space that is
+ * sparsely used only costs memory for the pages that were actually accessed.
+ */
+class paged_memory
+{
+
+public:
+    size_t const static PAGE_BITS = 12;
+    size_t const static PAGE_SIZE = 1 << PAGE_BITS; // 4096 cells per page.
+
+    unordered_map<long long, unsigned *> pages; // sparse page table, page number -> page cells.
+    long long lastPage;                         // page number of the most recent access.
+    unsigned *lastCells;                        // cells of the most recent page, skips the table lookup.
+
+    /**
+     * @brief The paged memory constructor starts with an empty page table.
+     */
+    paged_memory()
+    {
+        lastPage = -1;
+        lastCells = nullptr;
+    }
+
+    /**
+     * @brief The at method returns the cell stored at the given address, allocating a zeroed page
+     * the first time the page is touched.
+     * @param address The extended memory address.
+     * @return unsigned& the memory cell.
+     */
+    unsigned &at(long long address)
+    {
+        long long page = address >> PAGE_BITS;
+
+        if (page != lastPage) // most accesses stay on the same page as the previous one.
+        {
+            unsigned *&cells = pages[page];
+
+            if (cells == nullptr) // first touch of the page.
+            {
+                cells = new unsigned[PAGE_SIZE]();
+            }
+
+            lastPage = page;
+            lastCells = cells;
+        }
+
+        return lastCells[address & (PAGE_SIZE - 1)];
+    }
+
+    /**
+     * @brief The pagesAllocated method returns how many pages have been touched so far.
+     * @return size_t the number of allocated pages.
+     */
+    size_t pagesAllocated() const
+    {
+        return pages.size();
+    }
+
+    /**
+     * @brief The clear method frees every page, so the memory can be reused for another run.
+     */
+    void clear()
+    {
+        for (auto &page : pages)
+        {
+            delete[] page.second;
+        }
+        pages.clear();
+        lastPage = -1;
+        lastCells = nullptr;
+    }
+
+    /**
+     * @brief The deconstuctor of paged memory deletes every allocated page from the heap.
+     */
+    ~paged_memory()
+    {
+        for (auto &page : pages)
+        {
+            delete[] page.second;
+        }
+    }
+};
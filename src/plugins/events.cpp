@@ -0,0 +1,28 @@
+/*
+events.cpp
+Example analysis plugin: prints every cache event as it happens, with its pc, address, level, set and way.
+
+Build: g++ -O2 -std=c++17 -shared -fPIC -o events.so src/plugins/events.cpp
+Run:   simcache --cache 16,2,2 --plugin ./events.so program.bin
+*/
+
+#include <iostream>
+#include "../hooks.h"
+
+/**
+ * @brief Prints a cache event.
+ * @param event The cache event.
+ * @param context Unused.
+ */
+static void on_event(const cache_event *event, void *)
+{
+    static const char *kinds[] = {"ACCESS", "HIT", "MISS", "FILL", "EVICT", "WRITEBACK"};
+
+    cout << "Event L" << event->level << " " << kinds[event->kind] << " pc " << event->pc << " addr "
+         << event->address << " set " << event->set << " way " << event->way << endl;
+}
+
+extern "C" void e20_plugin_init(plugin_api *api)
+{
+    api->attach(on_event, nullptr, nullptr);
+}
@@ -0,0 +1,58 @@
+/*
+miss_pcs.cpp
+Example analysis plugin: counts the misses of every instruction at every cache level and prints the
+instructions with the most misses at the end of the run.
+
+Build: g++ -O2 -std=c++17 -shared -fPIC -o miss_pcs.so src/plugins/miss_pcs.cpp
+Run:   simcache --cache 16,2,2 --plugin ./miss_pcs.so program.bin
+*/
+
+#include <iostream>
+#include <map>
+#include <algorithm>
+#include "../hooks.h"
+
+/**
+ * @brief The misses counted so far, by cache level and pc.
+ */
+struct miss_counts
+{
+    map<pair<int, int>, long long> misses;
+};
+
+/**
+ * @brief Counts a miss event.
+ * @param event The cache event.
+ * @param context The miss counts.
+ */
+static void on_event(const cache_event *event, void *context)
+{
+    if (event->kind == EV_MISS)
+        ((miss_counts *)context)->misses[{event->level, event->pc}]++;
+}
+
+/**
+ * @brief Prints the ten instructions with the most misses.
+ * @param context The miss counts.
+ */
+static void on_finish(void *context)
+{
+    miss_counts *counts = (miss_counts *)context;
+    vector<pair<long long, pair<int, int>>> sorted;
+
+    for (auto &entry : counts->misses)
+        sorted.push_back({entry.second, entry.first});
+    sort(sorted.rbegin(), sorted.rend());
+
+    for (size_t i = 0; i < sorted.size() && i < 10; i++)
+    {
+        cout << "Misses L" << sorted[i].second.first << " pc " << sorted[i].second.second << ": "
+             << sorted[i].first << endl;
+    }
+    delete counts;
+}
+
+extern "C" void e20_plugin_init(plugin_api *api)
+{
+    api->attach(on_event, on_finish, new miss_counts());
+}
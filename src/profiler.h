@@ -0,0 +1,209 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include "e20.h"
+
+using namespace std;
+
+/**
+ * @brief The profiler class counts what a program does while it runs: executions of every opcode and every pc,
+ * jeq outcomes, and the cache misses of every load and store. All counts are flat arrays indexed by pc, so
+ * counting an instruction is a few increments. Basic blocks are found as the program runs: an instruction
+ * starts a block when it is the first one run, or it is not reached by falling through from the one before
+ * it, or the one before it was a jump or a branch. With several cores, falling through is followed for every
+ * core on its own, so interleaving the cores does not split the blocks.
+ */
+class profiler
+{
+
+public:
+    static const int PCS = e20_processor::MEM_SIZE;
+    static const int MNEMONICS = 24; // the funct of three register instructions 0-15, then opcodes 1-7.
+
+    /**
+     * @brief A basic block found by the run: its pcs, and the totals of the instructions in it.
+     */
+    struct basic_block
+    {
+        int start, end;          // first and last pc.
+        long long executions;    // times the block was entered.
+        long long instructions;  // instructions run in the block.
+        long long loads, stores;
+        long long misses[2];     // cache 1 and cache 2 misses of its loads and stores.
+    };
+
+    vector<long long> executed;          // executions of every pc.
+    vector<long long> taken, notTaken;   // outcomes of the jeq at every pc.
+    vector<long long> misses[2];         // cache 1 and cache 2 misses of the load or store at every pc.
+    vector<unsigned char> mnemonic;      // the instruction last run at every pc.
+    vector<bool> leader;                 // if a block starts at the pc.
+    long long opcodes[MNEMONICS];        // executions of every instruction.
+    long long instructions;              // every instruction run.
+    vector<int> next;                    // the pc that falls through from the last instruction of every core, -1 after a jump.
+
+    /**
+     * @brief The profiler constructor starts with nothing counted.
+     * @param cores number of cores adding to the profile, each running its own instruction stream.
+     */
+    profiler(int cores) : executed(PCS, 0), taken(PCS, 0), notTaken(PCS, 0), mnemonic(PCS, 0), leader(PCS, false),
+                          next(cores, -1)
+    {
+        misses[0].assign(PCS, 0);
+        misses[1].assign(PCS, 0);
+        fill(opcodes, opcodes + MNEMONICS, 0);
+        instructions = 0;
+    }
+
+    /**
+     * @brief The decode function returns the mnemonic number of an instruction.
+     * @param word the instruction.
+     * @return int the funct of a three register instruction, 16 plus the opcode of the others.
+     */
+    static int decode(unsigned word)
+    {
+        unsigned opcode = (word >> 13) & 7;
+        return (opcode == 0) ? (word & 15) : 16 + opcode;
+    }
+
+    /**
+     * @brief The name function returns the name of a mnemonic number.
+     */
+    static string name(int m)
+    {
+        static const char *names[MNEMONICS] = {"add", "sub", "and", "or", "slt", "op0-5", "op0-6", "op0-7",
+                                               "jr", "setseg", "op0-10", "op0-11", "op0-12", "op0-13", "op0-14",
+                                               "op0-15", "", "addi", "j", "jal", "lw", "sw", "jeq", "slti"};
+        return names[m];
+    }
+
+    /**
+     * @brief The is_control function tells if an instruction may not fall through to the next pc.
+     */
+    static bool is_control(int m)
+    {
+        return m == 8 || m == 18 || m == 19 || m == 22; // jr, j, jal, jeq.
+    }
+
+    /**
+     * @brief The execute function counts an instruction about to run.
+     * @param core the core running it.
+     * @param pc the pc of the instruction.
+     * @param word the instruction.
+     */
+    void execute(int core, int pc, unsigned word)
+    {
+        int m = decode(word);
+        pc &= PCS - 1;
+
+        if (pc != next[core])
+            leader[pc] = true;
+        next[core] = is_control(m) ? -1 : (pc + 1) & (PCS - 1);
+
+        executed[pc]++;
+        mnemonic[pc] = m;
+        opcodes[m]++;
+        instructions++;
+    }
+
+    /**
+     * @brief The branch function counts the outcome of a jeq.
+     * @param pc the pc of the jeq.
+     * @param isTaken if the branch is taken.
+     */
+    void branch(int pc, bool isTaken)
+    {
+        (isTaken ? taken : notTaken)[pc & (PCS - 1)]++;
+    }
+
+    /**
+     * @brief The miss function counts a cache miss of a load or a store.
+     * @param pc the pc of the load or store.
+     * @param level 1 for cache 1, 2 for cache 2.
+     */
+    void miss(int pc, int level)
+    {
+        misses[level - 1][pc & (PCS - 1)]++;
+    }
+
+    /**
+     * @brief The blocks function splits the pcs that ran into basic blocks. A block ends at a jump or a
+     * branch, before the start of another block, or before a pc that never ran.
+     * @return vector<basic_block> the blocks in pc order.
+     */
+    vector<basic_block> blocks() const
+    {
+        vector<basic_block> found;
+        bool open = false;
+
+        for (int pc = 0; pc < PCS; pc++)
+        {
+            if (executed[pc] == 0)
+            {
+                open = false;
+                continue;
+            }
+
+            if (!open || leader[pc])
+                found.push_back(basic_block{pc, pc, executed[pc], 0, 0, 0, {0, 0}});
+
+            basic_block &b = found.back();
+            b.end = pc;
+            b.instructions += executed[pc];
+            b.loads += (mnemonic[pc] == 20) ? executed[pc] : 0;
+            b.stores += (mnemonic[pc] == 21) ? executed[pc] : 0;
+            b.misses[0] += misses[0][pc];
+            b.misses[1] += misses[1][pc];
+            open = !is_control(mnemonic[pc]);
+        }
+        return found;
+    }
+
+    /**
+     * @brief The write_json function writes every count as JSON: the totals, the opcodes, every pc that
+     * ran, the basic blocks, and the jeq outcomes.
+     * @param out the file.
+     */
+    void write_json(ostream &out) const
+    {
+        out << "{\n  \"instructions\": " << instructions << ",\n  \"opcodes\": {";
+        const char *sep = "";
+        for (int m = 0; m < MNEMONICS; m++)
+        {
+            if (opcodes[m] > 0)
+            {
+                out << sep << "\"" << name(m) << "\": " << opcodes[m];
+                sep = ", ";
+            }
+        }
+
+        out << "},\n  \"pcs\": [";
+        sep = "";
+        for (int pc = 0; pc < PCS; pc++)
+        {
+            if (executed[pc] > 0)
+            {
+                out << sep << "\n    {\"pc\": " << pc << ", \"op\": \"" << name(mnemonic[pc]) << "\", \"count\": "
+                    << executed[pc] << ", \"l1_misses\": " << misses[0][pc] << ", \"l2_misses\": " << misses[1][pc];
+                if (mnemonic[pc] == 22)
+                    out << ", \"taken\": " << taken[pc] << ", \"not_taken\": " << notTaken[pc];
+                out << "}";
+                sep = ",";
+            }
+        }
+
+        out << "\n  ],\n  \"blocks\": [";
+        sep = "";
+        for (const basic_block &b : blocks())
+        {
+            out << sep << "\n    {\"start\": " << b.start << ", \"end\": " << b.end << ", \"executions\": "
+                << b.executions << ", \"instructions\": " << b.instructions << ", \"loads\": " << b.loads
+                << ", \"stores\": " << b.stores << ", \"l1_misses\": " << b.misses[0] << ", \"l2_misses\": "
+                << b.misses[1] << "}";
+            sep = ",";
+        }
+        out << "\n  ]\n}\n";
+    }
+};
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+/*
+    Server mode runs simulation jobs in a warm process listening on a Unix domain socket. Every message is a
+    list of netstrings ("5:hello,"). A request is the number of fields, the working directory of the client,
+    the program image (empty to read the program file on the server), and the command line arguments of the
+    job. A reply is the exit status, the standard output, and the standard error of the job. A connection may
+    carry any number of requests, each answered in order.
+*/
+
+/**
+ * @brief A simulation job sent by a client.
+ */
+struct job_request
+{
+    string cwd;          // working directory of the client, relative paths are resolved against it.
+    string image;        // program image, or empty to read the program file.
+    vector<string> args; // command line arguments, args[0] is the program name.
+};
+
+/**
+ * @brief The result of a job: what the command line would have returned and printed.
+ */
+struct job_reply
+{
+    int status;
+    string out, err;
+};
+
+/**
+ * @brief The socket_stream class reads and writes netstrings on a connected socket, buffering the reads.
+ */
+class socket_stream
+{
+
+public:
+    int fd;
+    string buffer; // bytes read but not used yet.
+    size_t pos;
+
+    socket_stream(int socket)
+    {
+        fd = socket;
+        pos = 0;
+    }
+
+    /**
+     * @brief The fill function reads more bytes from the socket.
+     * @return false at the end of the stream or on error.
+     */
+    bool fill()
+    {
+        char chunk[65536];
+        ssize_t n;
+        do
+        {
+            n = ::read(fd, chunk, sizeof(chunk));
+        } while (n < 0 && errno == EINTR);
+
+        if (n <= 0)
+            return false;
+
+        buffer.erase(0, pos);
+        pos = 0;
+        buffer.append(chunk, n);
+        return true;
+    }
+
+    /**
+     * @brief The read function reads one netstring.
+     * @param s the string read.
+     * @return false at the end of the stream or if the netstring is malformed.
+     */
+    bool read(string &s)
+    {
+        size_t length = 0;
+        while (true)
+        {
+            if (pos == buffer.size() && !fill())
+                return false;
+
+            char c = buffer[pos++];
+            if (c == ':')
+                break;
+            if (c < '0' || c > '9' || length > (1u << 30))
+                return false;
+            length = length * 10 + (c - '0');
+        }
+
+        while (buffer.size() - pos < length + 1)
+        {
+            if (!fill())
+                return false;
+        }
+
+        s.assign(buffer, pos, length);
+        pos += length;
+        return buffer[pos++] == ',';
+    }
+
+    /**
+     * @brief The read_number function reads a netstring holding a number.
+     * @param n the number read.
+     * @return false at the end of the stream or if the netstring is malformed.
+     */
+    bool read_number(long long &n)
+    {
+        string s;
+        if (!read(s) || s.empty() || s.size() > 18)
+            return false;
+        char *end;
+        errno = 0;
+        n = strtoll(s.c_str(), &end, 10);
+        return errno == 0 && end == s.c_str() + s.size();
+    }
+
+    /**
+     * @brief The write function sends a whole message.
+     * @param message the bytes to send.
+     * @return false if the peer went away.
+     */
+    bool write(const string &message)
+    {
+        size_t sent = 0;
+        while (sent < message.size())
+        {
+            ssize_t n = ::send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            sent += n;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Appends a netstring to a message.
+ * @param message the message.
+ * @param s the string to append.
+ */
+inline void append_netstring(string &message, const string &s)
+{
+    message += to_string(s.size());
+    message += ':';
+    message += s;
+    message += ',';
+}
+
+long long const static MAX_FIELDS = 4096; // most fields of a request, the command line arguments and two more.
+
+/**
+ * @brief Reads a job request.
+ * @param stream the connection.
+ * @param request the request read.
+ * @return false at the end of the stream or if the request is malformed.
+ */
+inline bool read_request(socket_stream &stream, job_request &request)
+{
+    long long fields;
+    if (!stream.read_number(fields) || fields < 3 || fields > MAX_FIELDS)
+        return false;
+
+    if (!stream.read(request.cwd) || !stream.read(request.image))
+        return false;
+
+    request.args.assign(fields - 2, "");
+    for (string &arg : request.args)
+    {
+        if (!stream.read(arg))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sends a job request.
+ * @param stream the connection.
+ * @param request the request.
+ * @return false if the server went away.
+ */
+inline bool write_request(socket_stream &stream, const job_request &request)
+{
+    string message;
+    append_netstring(message, to_string(request.args.size() + 2));
+    append_netstring(message, request.cwd);
+    append_netstring(message, request.image);
+    for (const string &arg : request.args)
+        append_netstring(message, arg);
+    return stream.write(message);
+}
+
+/**
+ * @brief Reads a job reply.
+ * @param stream the connection.
+ * @param reply the reply read.
+ * @return false if the server went away.
+ */
+inline bool read_reply(socket_stream &stream, job_reply &reply)
+{
+    long long status;
+    if (!stream.read_number(status) || !stream.read(reply.out) || !stream.read(reply.err))
+        return false;
+    reply.status = (int)status;
+    return true;
+}
+
+/**
+ * @brief Sends a job reply.
+ * @param stream the connection.
+ * @param reply the reply.
+ * @return false if the client went away.
+ */
+inline bool write_reply(socket_stream &stream, const job_reply &reply)
+{
+    string message;
+    append_netstring(message, to_string(reply.status));
+    append_netstring(message, reply.out);
+    append_netstring(message, reply.err);
+    return stream.write(message);
+}
+
+/**
+ * @brief Fills in the address of a Unix domain socket.
+ * @param path the socket path.
+ * @param address the address.
+ * @return false if the path is too long.
+ */
+inline bool socket_address(const string &path, sockaddr_un &address)
+{
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, path.c_str());
+    return true;
+}
+
+/**
+ * @brief Connects to a server.
+ * @param path the socket path.
+ * @return int the connected socket, or -1.
+ */
+inline int connect_server(const string &path)
+{
+    sockaddr_un address;
+    if (!socket_address(path, address))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr *)&address, sizeof(address)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// The socket of the running server, removed when the server is stopped by a signal.
+static char served_path[sizeof(sockaddr_un::sun_path)];
+
+/**
+ * @brief Removes the socket and exits when the server is stopped.
+ */
+inline void stop_server(int)
+{
+    unlink(served_path);
+    _exit(0);
+}
+
+/**
+ * @brief The serve function listens on a Unix domain socket and runs the jobs of every connection on a pool
+ * of worker threads. Each worker owns one connection at a time and answers its requests in order. It only
+ * returns if the socket can't be set up.
+ * @param path the socket path, replaced if it exists.
+ * @param workers number of worker threads.
+ * @param run runs a job on a worker, given the worker number.
+ * @return int 1 if the socket can't be set up.
+ */
+inline int serve(const string &path, int workers, function<void(const job_request &, job_reply &, int)> run)
+{
+    sockaddr_un address;
+    if (!socket_address(path, address))
+    {
+        cerr << "Socket path too long " << path << endl;
+        return 1;
+    }
+
+    unlink(path.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || ::bind(listener, (sockaddr *)&address, sizeof(address)) < 0 || listen(listener, 128) < 0)
+    {
+        cerr << "Can't listen on socket " << path << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    strcpy(served_path, path.c_str());
+    signal(SIGINT, stop_server);
+    signal(SIGTERM, stop_server);
+
+    deque<int> pending; // accepted connections waiting for a worker.
+    mutex lock;
+    condition_variable ready;
+    vector<thread> pool;
+
+    for (int worker = 0; worker < workers; worker++)
+    {
+        pool.emplace_back([&, worker]() {
+            job_request request;
+            job_reply reply;
+            while (true)
+            {
+                int fd;
+                {
+                    unique_lock<mutex> guard(lock);
+                    ready.wait(guard, [&]() { return !pending.empty(); });
+                    fd = pending.front();
+                    pending.pop_front();
+                }
+
+                socket_stream stream(fd);
+                try
+                {
+                    while (read_request(stream, request))
+                    {
+                        run(request, reply, worker);
+                        if (!write_reply(stream, reply))
+                            break;
+                    }
+                }
+                catch (const exception &e) // a bad request only costs its own connection.
+                {
+                    cerr << "Dropped a connection: " << e.what() << endl;
+                }
+                close(fd);
+            }
+        });
+    }
+
+    while (true)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+
+        lock_guard<mutex> guard(lock);
+        pending.push_back(fd);
+        ready.notify_one();
+    }
+}
@@ -13,8 +13,24 @@ simcache.cpp
 #include <limits>
 #include <iomanip>
 #include <regex>
+#include <deque>
+#include <dlfcn.h>
+#include <sstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stdexcept>
+#include <cerrno>
+#include <sys/stat.h>
 #include "e20.h"
 #include "cache.h"
+#include "coherence.h"
+#include "timing.h"
+#include "dram.h"
+#include "binlog.h"
+#include "tlb.h"
+#include "profiler.h"
+#include "server.h"
 
 using namespace std;
 
@@ -23,6 +39,12 @@ size_t const static NUM_REGS = 8;
 size_t const static MEM_SIZE = 1 << 13;
 size_t const static REG_SIZE = 1 << 16;
 
+// Where the log, the statistics, and the errors are printed. Every thread has its own so server workers can capture their job.
+thread_local ostream *sim_output = &cout;
+thread_local ostream *sim_errors = &cerr;
+thread_local binlog_writer *sim_binlog = nullptr; // takes the log entries when writing a binary log.
+thread_local istream *sim_input = &cin;           // where "-" reads from, nullptr for server jobs.
+
 /*
     Prints out the correctly-formatted configuration of a cache.
 
@@ -37,10 +59,13 @@ size_t const static REG_SIZE = 1 << 16;
 */
 void print_cache_config(const string &cache_name, int size, int assoc, int blocksize, int num_lines)
 {
-    cout << "Cache " << cache_name << " has size " << size << ", associativity " << assoc << ", blocksize " << blocksize << ", lines " << num_lines << endl;
+    *sim_output << "Cache " << cache_name << " has size " << size << ", associativity " << assoc << ", blocksize " << blocksize << ", lines " << num_lines << endl;
 }
 
-void load_machine_code(ifstream &f, unsigned mem[])
+/*
+    Loads a program into memory. Throws a runtime_error describing the first line that can't be loaded.
+*/
+void load_machine_code(istream &f, unsigned mem[])
 {
     regex machine_code_re("^ram\\[(\\d+)\\] = 16'b(\\d+);.*$");
     size_t expectedaddr = 0;
@@ -50,20 +75,17 @@ void load_machine_code(ifstream &f, unsigned mem[])
         smatch sm;
         if (!regex_match(line, sm, machine_code_re))
         {
-            cerr << "Can't parse line: " << line << endl;
-            exit(1);
+            throw runtime_error("Can't parse line: " + line);
         }
         size_t addr = stoi(sm[1], nullptr, 10);
         unsigned instr = stoi(sm[2], nullptr, 2);
         if (addr != expectedaddr)
         {
-            cerr << "Memory addresses encountered out of sequence: " << addr << endl;
-            exit(1);
+            throw runtime_error("Memory addresses encountered out of sequence: " + to_string(addr));
         }
         if (addr >= MEM_SIZE)
         {
-            cerr << "Program too big for memory" << endl;
-            exit(1);
+            throw runtime_error("Program too big for memory");
         }
         expectedaddr++;
         mem[addr] = instr;
@@ -87,10 +109,128 @@ void load_machine_code(ifstream &f, unsigned mem[])
     @param line The cache line or set number where the data
         is stored.
 */
-void print_log_entry(const string &cache_name, const string &status, int pc, int addr, int line)
+void print_log_entry(const string &cache_name, const string &status, int pc, long long addr, int line)
+{
+    if (sim_binlog != nullptr)
+    {
+        sim_binlog->entry(cache_name, status, pc, addr, line);
+        return;
+    }
+
+    *sim_output << left << setw(8) << cache_name + " " + status << right << " pc:" << 
+    setw(5) << pc << "\taddr:" << setw(5) << addr << "\tline:" << setw(4) << line << '\n'; // flushed as the buffer fills.
+}
+
+/**
+ * @brief Prints the hit and miss counts of one access stream at one cache level.
+ * @param name   The name of the stream, e.g. "I-fetch L1".
+ * @param hits   Number of hits.
+ * @param misses Number of misses.
+ */
+void print_stats(const string &name, long long hits, long long misses)
+{
+    long long accesses = hits + misses;
+    double rate = (accesses > 0) ? 100.0 * hits / accesses : 0.0;
+
+    *sim_output << name << " accesses " << accesses << ", hits " << hits << ", misses " << misses
+         << ", hit rate " << fixed << setprecision(2) << rate << "%" << endl;
+}
+
+/**
+ * @brief The sim_context struct gathers the cache hierarchy seen by the processor together with the
+ * optional features chosen on the command line, so they travel as one through the simulator.
+ */
+struct sim_context
+{
+    cache *l1, *l2;    // data cache 1 and cache 2.
+    bool isTwoCache;   // if wether we have 2 caches.
+    cache *il1;        // cache 1 used by instruction fetch: nullptr when not modelled, l1 when unified.
+    bool logFetch;     // print a log entry for every instruction fetch.
+    long long fetchHits[2], fetchMisses[2]; // instruction fetch statistics for cache 1 and cache 2.
+    mesi_bus *bus;     // coherence bus between the cores, nullptr with a single core.
+    int core;          // the core this context belongs to.
+    string prefix;     // log prefix naming the core, empty with a single core.
+    timing_model *timing; // cycle model of the core, nullptr when timing is not modelled.
+    tlb *translation;  // TLB of the core, nullptr when addresses are physical.
+    bool vipt;         // cache 1 is virtually indexed, so a TLB hit overlaps the cache access.
+    profiler *profile; // counts what the program does, nullptr when not profiling.
+
+    sim_context(cache &cache1, cache &cache2, bool twoCache)
+    {
+        l1 = &cache1;
+        l2 = &cache2;
+        isTwoCache = twoCache;
+        il1 = nullptr;
+        logFetch = false;
+        fetchHits[0] = fetchHits[1] = 0;
+        fetchMisses[0] = fetchMisses[1] = 0;
+        bus = nullptr;
+        core = 0;
+        timing = nullptr;
+        translation = nullptr;
+        vipt = false;
+        profile = nullptr;
+    }
+};
+
+/**
+ * @brief Scales the statistics of the sampled sets of a cache back up to the whole cache, with a 95% confidence
+ * interval from the spread between the sampled sets. When validating, the estimate is compared with the full
+ * model.
+ * @param name    The name of the cache.
+ * @param sampler The set sampler of the cache.
+ */
+void print_sampling_stats(const string &name, set_sampler &sampler)
 {
-    cout << left << setw(8) << cache_name + " " + status << right << " pc:" << 
-    setw(5) << pc << "\taddr:" << setw(5) << addr << "\tline:" << setw(4) << line << endl;
+    double n = sampler.sampledSets, N = sampler.numSets;
+    double sumA = 0, sumM = 0;
+
+    for (int set = 0; set < sampler.numSets; set++)
+    {
+        sumA += sampler.setAccesses[set];
+        sumM += sampler.setMisses[set];
+    }
+
+    double rate = (sumA > 0) ? sumM / sumA : 0.0;
+    double meanA = sumA / n, meanM = sumM / n;
+    double varD = 0, varM = 0; // sample variances of the ratio residuals and of the misses per set.
+
+    for (int set = 0; set < sampler.numSets; set++)
+    {
+        if (!sampler.sampled(set))
+            continue;
+
+        double d = sampler.setMisses[set] - rate * sampler.setAccesses[set];
+        double m = sampler.setMisses[set] - meanM;
+        varD += d * d;
+        varM += m * m;
+    }
+    if (n > 1)
+    {
+        varD /= n - 1;
+        varM /= n - 1;
+    }
+
+    double fpc = 1.0 - n / N; // finite population correction.
+    double rateCI = (meanA > 0) ? 1.96 * sqrt(fpc * varD / (n * meanA * meanA)) : 0.0;
+    double missCI = 1.96 * sqrt(N * N * fpc * varM / n);
+
+    *sim_output << "Sampled " << name << " sets " << sampler.sampledSets << " of " << sampler.numSets
+         << ", estimated accesses " << (long long)(sumA * N / n) << ", misses " << (long long)(sumM * N / n)
+         << " +/- " << (long long)missCI << ", miss rate " << fixed << setprecision(2) << 100.0 * rate
+         << "% +/- " << 100.0 * rateCI << "% (95% confidence)" << endl;
+
+    if (sampler.full != nullptr)
+    {
+        cache &full = *sampler.full;
+        long long accesses = full.hits + full.misses;
+        double fullRate = (accesses > 0) ? (double)full.misses / accesses : 0.0;
+        double error = rate - fullRate;
+
+        *sim_output << "Full " << name << " accesses " << accesses << ", misses " << full.misses << ", miss rate "
+             << 100.0 * fullRate << "%, estimation error " << 100.0 * error << "% ("
+             << ((fabs(error) <= rateCI) ? "inside" : "outside") << " the confidence interval)" << endl;
+    }
 }
 
 /**
@@ -231,6 +371,19 @@ void one_cache(int &L1assoc, int &L1size, int &L1blocksize, int &numLinesL1)
     }
 }
 
+/**
+ * @brief The valid_cache function checks a cache configuration before any of it is divided by: every part
+ * must be positive and the cache must have at least one line.
+ * @param size      cache size
+ * @param assoc     cache association
+ * @param blocksize cache blocksize
+ * @return true if the configuration can be simulated.
+ */
+bool valid_cache(int size, int assoc, int blocksize)
+{
+    return size >= 1 && assoc >= 1 && blocksize >= 1 && (long long)blocksize * assoc <= size;
+}
+
 /**
  * @brief  The One_cache gets the configution of an architecture that contains two caches.
  * 
@@ -281,269 +434,1928 @@ void two_cache(int &L1assoc, int &L2assoc, int &numLinesL1, int &numLinesL2, int
     }
 }
 
+/**
+ * @brief fetch_instr is a function that looks up the instruction at the program counter in the instruction
+ * cache, and in cache 2 when it misses. Fetches are counted separately from data accesses.
+ * 
+ * @param instuction  e20 processor
+ * @param ctx  the cache hierarchy
+ */
+void fetch_instr(e20_processor &instuction, sim_context &ctx)
+{
+    cache &il1 = *ctx.il1;
+    cache &l2 = *ctx.l2;
+    long long address = instuction.pc & 8191;
+    const string name = ctx.prefix + ((ctx.il1 == ctx.l1) ? "L1" : "L1I"); // unified or split cache 1.
+
+    il1.pc = instuction.pc;
+    il1.config_Cache(address);
+    if (!il1.in_sample(address)) // set sampling drops accesses to the other sets.
+        return;
+    il1.cacheType();
+
+    if (il1.status == "HIT")
+        ctx.fetchHits[0]++;
+    else
+        ctx.fetchMisses[0]++;
+
+    if (ctx.logFetch)
+        print_log_entry(name, "I" + il1.status, instuction.pc, address, il1.line);
+
+    if ((il1.status == "MISS") && (ctx.isTwoCache == true)) // cache 2 is shared with the data.
+    {
+        l2.pc = instuction.pc;
+        l2.config_Cache(address);
+        if (!l2.in_sample(address))
+            return;
+        l2.cacheType();
+
+        if (l2.status == "HIT")
+            ctx.fetchHits[1]++;
+        else
+            ctx.fetchMisses[1]++;
+
+        if (ctx.logFetch)
+            print_log_entry(ctx.prefix + "L2", "I" + l2.status, instuction.pc, address, l2.line);
+    }
+
+    if (ctx.timing != nullptr)
+        ctx.timing->fetch(il1.status == "HIT", ctx.isTwoCache, l2.status == "HIT", address);
+}
+
+/**
+ * @brief print_fetch_stats prints the instruction fetch and data statistics of every cache level.
+ * Data statistics exclude fetches when cache 1 is unified.
+ * 
+ * @param ctx  the cache hierarchy
+ */
+void print_fetch_stats(sim_context &ctx)
+{
+    long long sharedHits = (ctx.il1 == ctx.l1) ? ctx.fetchHits[0] : 0;
+    long long sharedMisses = (ctx.il1 == ctx.l1) ? ctx.fetchMisses[0] : 0;
+
+    print_stats(ctx.prefix + "I-fetch L1", ctx.fetchHits[0], ctx.fetchMisses[0]);
+    print_stats(ctx.prefix + "Data L1", ctx.l1->hits - sharedHits, ctx.l1->misses - sharedMisses);
+
+    if (ctx.isTwoCache && ctx.bus == nullptr) // a shared cache 2 is reported once for all cores.
+    {
+        print_stats("I-fetch L2", ctx.fetchHits[1], ctx.fetchMisses[1]);
+        print_stats("Data L2", ctx.l2->hits - ctx.fetchHits[1], ctx.l2->misses - ctx.fetchMisses[1]);
+    }
+}
+
+/**
+ * @brief translate is a function that maps the virtual address of a load or store to its physical address.
+ * A miss in every TLB walks the page table, reading the entry of the page through the data caches. With
+ * timing, a walk stalls for the latency of that read, an L2 TLB hit for the cache 1 latency, and without a
+ * virtually indexed cache 1 every lookup adds a cycle before the cache access.
+ * 
+ * @param instuction  e20 processor
+ * @param ctx  the cache hierarchy
+ * @param address virtual memory address
+ * @return long long the physical address.
+ */
+long long translate(e20_processor &instuction, sim_context &ctx, long long address)
+{
+    tlb &t = *ctx.translation;
+    long long pageSize = t.table->pageSize;
+    long long vpn = address / pageSize;
+    long long stall = ctx.vipt ? 0 : 1;
+
+    if (!t.lookup(vpn)) // walk the page table.
+    {
+        cache &l1 = *ctx.l1;
+        cache &l2 = *ctx.l2;
+        long long entry = t.table->entry_address(vpn);
+
+        if (ctx.bus != nullptr)
+            ctx.bus->read(ctx.core, entry);
+
+        l1.pc = instuction.pc;
+        l1.config_Cache(entry);
+        if (l1.in_sample(entry))
+        {
+            l1.cacheType();
+            print_log_entry(ctx.prefix + "L1", "W" + l1.status, instuction.pc, entry, l1.line);
+
+            if ((l1.status == "MISS") && (ctx.isTwoCache == true))
+            {
+                l2.pc = instuction.pc;
+                l2.config_Cache(entry);
+                if (l2.in_sample(entry))
+                {
+                    l2.cacheType();
+                    print_log_entry(ctx.prefix + "L2", "W" + l2.status, instuction.pc, entry, l2.line);
+                }
+            }
+        }
+
+        bool l1Hit = l1.status == "HIT";
+        bool l2Hit = ctx.isTwoCache && l2.status == "HIT";
+        t.walkHits[l1Hit ? 0 : (l2Hit ? 1 : 2)]++;
+
+        if (ctx.timing != nullptr)
+            stall += l1Hit ? ctx.timing->l1Latency : ctx.timing->miss_latency(ctx.isTwoCache, l2Hit, entry);
+    }
+    else if (t.l1.status == "MISS" && ctx.timing != nullptr) // L2 TLB hit.
+    {
+        stall += ctx.timing->l1Latency;
+    }
+
+    if (ctx.timing != nullptr)
+        ctx.timing->translate(stall);
+
+    return t.table->frame(vpn) * pageSize + address % pageSize;
+}
+
 /**
  * @brief load_instr is a function checks if a load instuction will produce a hit or miss.
  * 
  * @param instuction  e20 processor
- * @param l1  cache 1
- * @param l2  cache 2
- * @param isTwoCache  if wether we have 2 caches.
+ * @param ctx  the cache hierarchy
  * @param address memory address 
  */
-void load_instr(e20_processor &instuction, cache &l1, cache &l2, bool isTwoCache, int address)
+void load_instr(e20_processor &instuction, sim_context &ctx, long long address)
 {
+    cache &l1 = *ctx.l1;
+    cache &l2 = *ctx.l2;
+    bool isTwoCache = ctx.isTwoCache;
+
+    if (ctx.translation != nullptr) // the caches see physical addresses.
+        address = translate(instuction, ctx, address);
+
+    if (ctx.bus != nullptr) // snoop the load before the private cache fills.
+        ctx.bus->read(ctx.core, address);
 
+    l1.pc = instuction.pc;
     l1.config_Cache(address);  // configure the cache
+    if (!l1.in_sample(address)) // set sampling drops accesses to the other sets.
+        return;
     l1.cacheType();            // selects the cache type
+    if (ctx.profile != nullptr && l1.status == "MISS")
+        ctx.profile->miss(instuction.pc, 1);
 
-    print_log_entry("L1", l1.status, instuction.pc, address, l1.line); 
+    print_log_entry(ctx.prefix + "L1", l1.status, instuction.pc, address, l1.line); 
 
     if ((l1.status == "MISS") && (isTwoCache == true)) // if cache 1 is a miss and we have two caches, check cache 2.
     {
+        l2.pc = instuction.pc;
         l2.config_Cache(address);  // configure the cache 2
+        if (!l2.in_sample(address))
+            return;
         l2.cacheType();        // selects the cache 2 type
+        if (ctx.profile != nullptr && l2.status == "MISS")
+            ctx.profile->miss(instuction.pc, 2);
 
-        print_log_entry("L2", l2.status, instuction.pc, address, l2.line);
+        print_log_entry(ctx.prefix + "L2", l2.status, instuction.pc, address, l2.line);
     }
+
+    if (ctx.timing != nullptr) // work out when the loaded data is ready.
+        ctx.timing->load(l1.blockID, l1.status == "HIT", isTwoCache, l2.blockID, l2.status == "HIT", address);
 }
 
 /**
  * @brief write_instr is a function checks wether to write to the cache.
  * 
  * @param instuction  e20 processor
- * @param l1 cache 1
- * @param l2 cache 2
- * @param isTwoCache if wether we have 2 caches
+ * @param ctx  the cache hierarchy
  * @param address   memory address 
  */
-void write_instr(e20_processor &instuction, cache &l1, cache &l2, bool isTwoCache, int address)
+void write_instr(e20_processor &instuction, sim_context &ctx, long long address)
 {
+    cache &l1 = *ctx.l1;
+    cache &l2 = *ctx.l2;
+    bool isTwoCache = ctx.isTwoCache;
+
+    if (ctx.translation != nullptr) // the caches see physical addresses.
+        address = translate(instuction, ctx, address);
+
+    if (ctx.bus != nullptr) // snoop the store before the private cache fills.
+        ctx.bus->write(ctx.core, address);
 
+    l1.pc = instuction.pc;
     l1.config_Cache(address);
+    if (!l1.in_sample(address)) // set sampling drops accesses to the other sets.
+        return;
     l1.cacheType();
+    if (ctx.profile != nullptr && l1.status == "MISS")
+        ctx.profile->miss(instuction.pc, 1);
 
-    print_log_entry("L1", "SW", instuction.pc, address, l1.line);
+    print_log_entry(ctx.prefix + "L1", "SW", instuction.pc, address, l1.line);
+
+    if (isTwoCache == false)
+        l1.mark_dirty(); // the only cache holds the store.
 
     if (isTwoCache == true)
     {
+        l1.writeback(); // write-through to cache 2.
+
+        l2.pc = instuction.pc;
         l2.config_Cache(address);
+        if (!l2.in_sample(address))
+            return;
         l2.cacheType();
+        l2.mark_dirty(); // cache 1 writes through, cache 2 holds the store.
+        if (ctx.profile != nullptr && l2.status == "MISS")
+            ctx.profile->miss(instuction.pc, 2);
 
-        print_log_entry("L2", "SW", instuction.pc, address, l2.line);
+        print_log_entry(ctx.prefix + "L2", "SW", instuction.pc, address, l2.line);
     }
 }
 
 /**
- * @brief The e20Sim fuction simulates the e20 processor.
+ * @brief The e20Step fuction executes a single instruction of the e20 processor.
  * 
  * @param instuction e20 processor
- * @param l1  cache 1
- * @param l2  cache 2
- * @param isTwoCache wether if we have two caches.
+ * @param ctx  the cache hierarchy
+ * @return true if the instruction halted the processor.
  */
-void e20Sim(e20_processor &instuction, cache &l1, cache &l2, bool isTwoCache)
+bool e20Step(e20_processor &instuction, sim_context &ctx)
 {
 
     unsigned opcode, regSrcA, regSrcB, regDst;
 
     bool halt = false; // condtion on when to end the program.
 
-    while (halt == false)
+    setMemSize(instuction.memory); // sets memory to 16 bits.
+    setRegSize(instuction.regs);   // sets registers to 16 bits.
+    ctx.l2->requester = ctx.core;  // for the ways of a partitioned cache 2.
+
+    if (ctx.il1 != nullptr) // every fetch goes through the instruction cache.
     {
+        fetch_instr(instuction, ctx);
+    }
 
-        setMemSize(instuction.memory); // sets memory to 16 bits.
-        setRegSize(instuction.regs);   // sets registers to 16 bits.
+    opcode = instuction.memory[instuction.pc & 8191] >> 13; // shifts 13 bits to the right to get 3 bits MSB.
 
-        opcode = instuction.memory[instuction.pc & 8191] >> 13; // shifts 13 bits to the right to get 3 bits MSB.
+    if (ctx.profile != nullptr)
+        ctx.profile->execute(ctx.core, instuction.pc, instuction.memory[instuction.pc & 8191]);
 
-        if (isThreeRegInstc(opcode) == true)
-        { // if its a three registers instuction.
+    if (isThreeRegInstc(opcode) == true)
+    { // if its a three registers instuction.
 
-            regSrcA = ((instuction.memory[instuction.pc & 8191] & 0b0001110000000000) >> 10);
-            regSrcB = ((instuction.memory[instuction.pc & 8191] & 0b0000001110000000) >> 7);
-            regDst = ((instuction.memory[instuction.pc & 8191] & 0b0000000001110000) >> 4);
-            instuction.imm = (instuction.memory[instuction.pc & 8191] & 0b0000000000001111);
+        regSrcA = ((instuction.memory[instuction.pc & 8191] & 0b0001110000000000) >> 10);
+        regSrcB = ((instuction.memory[instuction.pc & 8191] & 0b0000001110000000) >> 7);
+        regDst = ((instuction.memory[instuction.pc & 8191] & 0b0000000001110000) >> 4);
+        instuction.imm = (instuction.memory[instuction.pc & 8191] & 0b0000000000001111);
 
-            instuction.getThreeRegInst(regSrcA, regSrcB, regDst);
+        if (ctx.timing != nullptr) // wait for the operands and the destination.
+        {
+            ctx.timing->wait_for(regSrcA);
+            ctx.timing->wait_for(regSrcB);
+            ctx.timing->wait_for(regDst);
         }
 
-        else if (isTwoRegInstc(opcode) == true)
-        { // if its a two registers instuction.
-
-            regSrcA = ((instuction.memory[instuction.pc & 8191] & 0b0001110000000000) >> 10);
-            regSrcB = ((instuction.memory[instuction.pc & 8191] & 0b0000001110000000) >> 7);
-            instuction.imm = (instuction.memory[instuction.pc & 8191] & 0b0000000001111111);
+        instuction.getThreeRegInst(regSrcA, regSrcB, regDst);
+    }
 
-            // if imm is outside the singed range 2^6-1 sign extend.
-            if (instuction.imm & 64)
-            {
-                instuction.imm = sign_extension(instuction.imm);
-            }
-            
-         
-            if (opcode == 0b100)  // If "LW"
-            {
-                int address = instuction.imm + instuction.regs[regSrcA];
-                load_instr(instuction, l1, l2, isTwoCache, address);
-            }
-    
-            else if (opcode == 0b101)   // If "SW"
-            {
-                int address = instuction.imm + instuction.regs[regSrcA];
-                write_instr(instuction, l1, l2, isTwoCache,  address);
-            }
+    else if (isTwoRegInstc(opcode) == true)
+    { // if its a two registers instuction.
 
-            instuction.getTwoRegInst(opcode, regSrcA, regSrcB);
+        regSrcA = ((instuction.memory[instuction.pc & 8191] & 0b0001110000000000) >> 10);
+        regSrcB = ((instuction.memory[instuction.pc & 8191] & 0b0000001110000000) >> 7);
+        instuction.imm = (instuction.memory[instuction.pc & 8191] & 0b0000000001111111);
 
+        // if imm is outside the singed range 2^6-1 sign extend.
+        if (instuction.imm & 64)
+        {
+            instuction.imm = sign_extension(instuction.imm);
         }
 
-        else if (isNoRegInstc(opcode) == true)
-        { // if its a no registers instuction.
+        if (ctx.timing != nullptr) // wait for the operands, regSrcB is also the destination of a load.
+        {
+            ctx.timing->wait_for(regSrcA);
+            ctx.timing->wait_for(regSrcB);
+        }
+        
+     
+        if (opcode == 0b100)  // If "LW"
+        {
+            long long address = instuction.data_address(regSrcA, instuction.imm);
+            load_instr(instuction, ctx, address);
 
-            instuction.imm = (instuction.memory[instuction.pc & 8191] & 0b0001111111111111);
+            if (ctx.timing != nullptr)
+                ctx.timing->regReady[regSrcB] = ctx.timing->lastReady;
+        }
 
-            // halt if its a jump instuction and program counter is equal to imm.
-            if ((opcode == 0b010) && ((instuction.pc & 8191) == instuction.imm))
-            {
-                halt = true;
-            }
+        else if (opcode == 0b101)   // If "SW"
+        {
+            long long address = instuction.data_address(regSrcA, instuction.imm);
+            write_instr(instuction, ctx, address);
+        }
 
-            instuction.getNoRegInst(opcode);
+        else if (opcode == 0b110 && ctx.profile != nullptr) // If "JEQ"
+        {
+            ctx.profile->branch(instuction.pc, instuction.regs[regSrcA] == instuction.regs[regSrcB]);
         }
 
-        else
-        { // If given an invalid operation.
+        instuction.getTwoRegInst(opcode, regSrcA, regSrcB);
+
+    }
+
+    else if (isNoRegInstc(opcode) == true)
+    { // if its a no registers instuction.
+
+        instuction.imm = (instuction.memory[instuction.pc & 8191] & 0b0001111111111111);
 
-            cerr << "Invalid E20 Instuctions." << endl;
-            exit(1);
+        if ((ctx.timing != nullptr) && (opcode == 0b011)) // jal writes $7.
+            ctx.timing->wait_for(7);
+
+        // halt if its a jump instuction and program counter is equal to imm.
+        if ((opcode == 0b010) && ((instuction.pc & 8191) == instuction.imm))
+        {
+            halt = true;
         }
 
-        instuction.regs[0] = setRegZero(instuction.regs[0]); // make $0 immutable.
+        instuction.getNoRegInst(opcode);
+    }
+
+    else
+    { // If given an invalid operation.
+
+        throw runtime_error("Invalid E20 Instuctions.");
+    }
+
+    instuction.regs[0] = setRegZero(instuction.regs[0]); // make $0 immutable.
+
+    if (ctx.timing != nullptr)
+    {
+        ctx.timing->retire_instr();
+        if (halt)
+            ctx.timing->drain();
     }
+
+    return halt;
 }
 
 /**
-    Main function
-    Takes command-line args as documented below
-*/
-int main(int argc, char *argv[])
+ * @brief The e20Sim fuction simulates the e20 processor until it halts.
+ * 
+ * @param instuction e20 processor
+ * @param ctx  the cache hierarchy
+ */
+void e20Sim(e20_processor &instuction, sim_context &ctx)
 {
+    while (e20Step(instuction, ctx) == false)
+    {
+    }
+}
 
-    /*
-        Parse the command-line arguments
-    */
-    char *filename = nullptr;
-    bool do_help = false;
-    bool arg_error = false;
-    string cache_config;
-    for (int i = 1; i < argc; i++)
+/**
+ * @brief The e20MultiSim fuction simulates several e20 cores over one memory image. The cores take turns
+ * executing one instruction each in a fixed round-robin order, or with timing the core that is furthest
+ * behind goes next, so every run interleaves the same way.
+ * 
+ * @param cores the e20 cores
+ * @param ctxs  the cache hierarchy of every core
+ */
+void e20MultiSim(deque<e20_processor> &cores, vector<sim_context> &ctxs)
+{
+    vector<bool> halted(cores.size(), false);
+    size_t running = cores.size();
+
+    while (running > 0)
     {
-        string arg(argv[i]);
-        if (arg.rfind("-", 0) == 0)
+        for (size_t core = 0; core < cores.size(); core++)
         {
-            if (arg == "-h" || arg == "--help")
-                do_help = true;
-            else if (arg == "--cache")
+            size_t next = core;
+
+            if (ctxs[0].timing != nullptr) // by cycle, ties go to the lowest core.
             {
-                i++;
-                if (i >= argc)
-                    arg_error = true;
-                else
-                    cache_config = argv[i];
+                next = cores.size();
+                for (size_t other = 0; other < cores.size(); other++)
+                {
+                    if (!halted[other] && (next == cores.size() || ctxs[other].timing->cycle < ctxs[next].timing->cycle))
+                        next = other;
+                }
+                if (next == cores.size())
+                    break;
+            }
+
+            if (!halted[next] && e20Step(cores[next], ctxs[next]))
+            {
+                halted[next] = true;
+                running--;
             }
-            else
-                arg_error = true;
-        }
-        else
-        {
-            if (filename == nullptr)
-                filename = argv[i];
-            else
-                arg_error = true;
         }
     }
-    /* Display error message if appropriate */
-    if (arg_error || do_help || filename == nullptr)
-    {
-        cerr << "usage " << argv[0] << " [-h] [--cache CACHE] filename" << endl
-             << endl;
-        cerr << "Simulate E20 cache" << endl
-             << endl;
-        cerr << "positional arguments:" << endl;
-        cerr << "  filename    The file containing machine code, typically with .bin suffix" << endl
-             << endl;
-        cerr << "optional arguments:" << endl;
-        cerr << "  -h, --help  show this help message and exit" << endl;
-        cerr << "  --cache CACHE  Cache configuration: size,associativity,blocksize (for one" << endl;
-        cerr << "                 cache) or" << endl;
-        cerr << "                 size,associativity,blocksize,size,associativity,blocksize" << endl;
-        cerr << "                 (for two caches)" << endl;
-        return 1;
-    }
+}
 
-    ifstream f(filename);
-    if (!f.is_open())
+/**
+ * @brief The trace_number function parses an address or pc of a trace, or a record number: decimal, or hex after 0x.
+ * @param text the number.
+ * @param n set to the number.
+ * @return true if all of text is a number that is not negative.
+ */
+bool trace_number(const string &text, long long &n)
+{
+    bool hex = text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+    const char *digits = text.c_str() + (hex ? 2 : 0);
+    if (!isxdigit((unsigned char)digits[0]))
+        return false;
+
+    char *end;
+    errno = 0;
+    n = strtoll(digits, &end, hex ? 16 : 10);
+    return errno == 0 && *end == '\0';
+}
+
+/**
+ * @brief The replay_trace function runs an address trace through the data caches in place of a program.
+ * Every line is a load (R or L) or a store (W or S) of an address, with an optional pc for the log. The
+ * trace is read a line at a time, so a pipe feeding it is only read as fast as the caches go, and the
+ * output is flushed every 4096 accesses.
+ *
+ * @param in the trace
+ * @param instuction e20 processor, only its pc is used
+ * @param ctx  the cache hierarchy
+ */
+void replay_trace(istream &in, e20_processor &instuction, sim_context &ctx)
+{
+    string line;
+    long long accesses = 0;
+
+    while (getline(in, line))
     {
-        cerr << "Can't open file " << filename << endl;
-        return 1;
+        istringstream words(line);
+        string kind, address, pcText;
+        long long addr, pc = 0;
+        if (!(words >> kind) || kind[0] == '#') // blank lines and comments.
+            continue;
+
+        bool parsed = kind.size() == 1 && words >> address && trace_number(address, addr);
+        if (parsed && words >> pcText)
+            parsed = trace_number(pcText, pc);
+        if (!parsed || !(words >> ws).eof()) // nothing may follow the pc.
+            throw runtime_error("Can't parse trace line: " + line);
+
+        instuction.pc = pc;
+        if (kind == "R" || kind == "L")
+            load_instr(instuction, ctx, addr);
+        else if (kind == "W" || kind == "S")
+            write_instr(instuction, ctx, addr);
+        else
+            throw runtime_error("Can't parse trace line: " + line);
+
+        if (ctx.timing != nullptr)
+            ctx.timing->retire_instr();
+        if (++accesses % 4096 == 0)
+            sim_output->flush();
     }
+}
 
-    e20_processor instuction; // instantiating e20 processor.
+/**
+ * @brief print_timing_stats prints the cycles of a core, and the MSHR statistics when the caches are
+ * non-blocking.
+ * 
+ * @param prefix the log prefix naming the core
+ * @param timing the cycle model of the core
+ * @param isTwoCache if wether we have 2 caches
+ */
+void print_timing_stats(const string &prefix, timing_model &timing, bool isTwoCache)
+{
+    long long cycles = max(timing.cycle, 1LL);
 
-    load_machine_code(f, instuction.memory);
+    *sim_output << prefix << "Timing cycles " << timing.cycle << ", instructions " << timing.instructions << ", CPI "
+         << fixed << setprecision(2) << (double)timing.cycle / max(timing.instructions, 1LL)
+         << ", load-use stall cycles " << timing.useStalls << ", miss stall cycles " << timing.missStalls << endl;
 
-    int numLinesL1, L1size, L1assoc, L1blocksize;
-    int numLinesL2, L2size, L2assoc, L2blocksize;
-    bool isTwoCache;
+    if (!timing.nonBlocking)
+        return;
 
-    /* parse cache config */
-    if (cache_config.size() > 0)
+    mshr_file *files[2] = {timing.l1Mshr, timing.l2Mshr};
+    for (int level = 0; level < (isTwoCache ? 2 : 1); level++)
     {
-        vector<int> parts;
-        size_t pos;
-        size_t lastpos = 0;
-        while ((pos = cache_config.find(",", lastpos)) != string::npos)
-        {
-            parts.push_back(stoi(cache_config.substr(lastpos, pos)));
-            lastpos = pos + 1;
-        }
-        parts.push_back(stoi(cache_config.substr(lastpos)));
-        if (parts.size() == 3)
-        {
-            L1size = parts[0];
-            L1assoc = parts[1];
-            L1blocksize = parts[2];
-            isTwoCache = false;
-
-            one_cache(L1assoc, L1size, L1blocksize, numLinesL1); //sets cache 1 configrations.
-        }
-        else if (parts.size() == 6)
-        {
+        mshr_file &m = *files[level];
+        *sim_output << prefix << "MSHR L" << level + 1 << " registers " << m.capacity << ", primary misses " << m.primary
+             << ", merges " << m.merges << ", full stall cycles " << m.fullStalls << ", average occupancy "
+             << (double)m.busyCycles / cycles << ", peak occupancy " << m.peak << endl;
+    }
+}
 
-            L1size = parts[0];
-            L1assoc = parts[1];
-            L1blocksize = parts[2];
-            L2size = parts[3];
-            L2assoc = parts[4];
-            L2blocksize = parts[5];
-            isTwoCache = true;
-             
-            //sets cache 1 and 2 configrations.
-            two_cache(L1assoc, L2assoc, numLinesL1, numLinesL2, L1size, L2size, L1blocksize, L2blocksize);
-        }
+/**
+ * @brief print_coherence_stats prints the statistics of every core and the coherence traffic of the bus.
+ * 
+ * @param ctxs  the cache hierarchy of every core
+ * @param bus   the coherence bus
+ */
+void print_coherence_stats(vector<sim_context> &ctxs, mesi_bus &bus)
+{
+    for (sim_context &ctx : ctxs)
+    {
+        if (ctx.il1 != nullptr)
+            print_fetch_stats(ctx);
         else
+            print_stats(ctx.prefix + "L1", ctx.l1->hits, ctx.l1->misses);
+    }
+
+    if (ctxs[0].isTwoCache)
+    {
+        cache &l2 = *ctxs[0].l2;
+        print_stats("Shared L2", l2.hits, l2.misses);
+
+        if (ctxs[0].il1 != nullptr) // split the shared cache 2 into the fetches of every core and the data.
         {
-            cerr << "Invalid cache config" << endl;
-            return 1;
+            long long fetchHits = 0, fetchMisses = 0;
+            for (sim_context &ctx : ctxs)
+            {
+                fetchHits += ctx.fetchHits[1];
+                fetchMisses += ctx.fetchMisses[1];
+            }
+            print_stats("I-fetch L2", fetchHits, fetchMisses);
+            print_stats("Data L2", l2.hits - fetchHits, l2.misses - fetchMisses);
         }
-  
-        cache l1 (numLinesL1, L1blocksize, L1assoc);  // instantiating Cache 1.
-        cache l2 (numLinesL2, L2blocksize, L2assoc);  // instantiating Cache 2.
-      
-        e20Sim(instuction, l1, l2, isTwoCache);      // Run the e20 processor.
+    }
 
+    for (sim_context &ctx : ctxs)
+    {
+        if (ctx.timing != nullptr)
+            print_timing_stats(ctx.prefix, *ctx.timing, ctx.isTwoCache);
     }
 
-    return 0;
+    *sim_output << "Coherence bus reads " << bus.busReads << ", read-exclusives " << bus.busReadExs
+         << ", upgrades " << bus.upgrades << ", invalidations " << bus.invalidations
+         << " (false sharing " << bus.falseSharing << "), interventions " << bus.interventions << endl;
 }
+
+/**
+ * @brief print_dram_stats prints the row buffer locality of main memory and the cycles it took per read.
+ * 
+ * @param memory the main memory model
+ */
+void print_dram_stats(dram &memory)
+{
+    long long requests = max(memory.requests, 1LL);
+
+    *sim_output << "DRAM " << (memory.openPage ? "open" : "close") << "-page requests " << memory.requests
+         << ", row hits " << memory.rowHits << ", row misses " << memory.rowMisses << ", row conflicts "
+         << memory.rowConflicts << ", row hit rate " << fixed << setprecision(2) << 100.0 * memory.rowHits / requests
+         << "%, reordered " << memory.reordered << ", average latency " << (double)memory.totalLatency / requests
+         << " cycles" << endl;
+}
+
+/**
+ * @brief print_tlb_stats prints the TLB hit rates of a core and the traffic of its page walks.
+ * 
+ * @param prefix the log prefix naming the core
+ * @param t the TLB of the core
+ * @param timing the cycle model of the core, nullptr when timing is not modelled
+ */
+void print_tlb_stats(const string &prefix, tlb &t, timing_model *timing)
+{
+    print_stats(prefix + "TLB L1", t.l1.hits, t.l1.misses);
+    if (t.hasL2)
+        print_stats(prefix + "TLB L2", t.l2.hits, t.l2.misses);
+
+    *sim_output << prefix << "Page walks " << t.walks << ", entries read from L1 " << t.walkHits[0] << ", L2 "
+         << t.walkHits[1] << ", memory " << t.walkHits[2];
+    if (timing != nullptr)
+        *sim_output << ", translation stall cycles " << timing->translationStalls;
+    *sim_output << endl;
+}
+
+/**
+ * @brief Attaches a way predictor to an associative cache, keeping it with the name it is reported under.
+ * Caches with a single way have nothing to predict.
+ * @param predictors The way predictors of the run and their names.
+ * @param name The name of the cache in the report.
+ * @param c The cache.
+ * @param byPc Predict by pc instead of the most recently used block.
+ */
+void attach_way_predictor(deque<pair<string, way_predictor>> &predictors, const string &name, cache &c, bool byPc)
+{
+    if (c.associate < 2)
+        return;
+    predictors.emplace_back(name, way_predictor(byPc));
+    c.predictor = &predictors.back().second;
+}
+
+/**
+ * @brief Prints how often the way predictor of every associative cache guessed the block that hit, so the
+ * hit could be served by reading a single way.
+ * @param predictors The way predictors of the run and their names.
+ */
+void print_way_stats(deque<pair<string, way_predictor>> &predictors)
+{
+    for (auto &named : predictors)
+    {
+        way_predictor &p = named.second;
+        long long hits = p.firstProbe + p.secondProbe;
+        double accuracy = (hits > 0) ? 100.0 * p.firstProbe / hits : 0.0;
+
+        *sim_output << "Way prediction " << named.first << " (" << (p.byPc ? "pc" : "mru") << ") hits " << hits
+             << ", first probe " << p.firstProbe << ", second probe " << p.secondProbe << ", misses " << p.misses
+             << ", accuracy " << fixed << setprecision(2) << accuracy << "%" << endl;
+    }
+}
+
+/**
+ * @brief Prints the sector statistics of a sectored cache: the accesses whose tag hit, those of them that
+ * missed their sector, the cells fetched from the next level against what whole block fills would fetch,
+ * and the dirty sectors written back.
+ * @param name The name of the cache in the report.
+ * @param c The cache.
+ */
+void print_sector_stats(const string &name, cache &c)
+{
+    if (c.sectorSize == 0)
+        return;
+
+    long long blockFills = (c.misses - c.sectorMisses) * c.blockSize; // what filling whole blocks would fetch.
+    *sim_output << "Sectors " << name << " size " << c.sectorSize << ", tag hits " << c.hits + c.sectorMisses
+         << ", sector misses " << c.sectorMisses << ", cells fetched " << c.cellsFetched << " (whole blocks "
+         << blockFills << "), dirty sector writebacks " << c.dirtyWritebacks << endl;
+}
+
+/**
+ * @brief Prints how set dueling went: the policy selector at the end and its range, the accesses of the sets
+ * under each policy, the misses of the leaders, and the trajectory of the selector over the run.
+ * @param name The name of the cache in the report.
+ * @param d The set dueling of the cache.
+ */
+void print_dueling_stats(const string &name, set_dueling &d)
+{
+    long long accesses = max(d.accesses[0] + d.accesses[1], 1LL);
+
+    *sim_output << "Set dueling " << name << " PSEL " << d.psel << " (min " << d.pselMin << ", max " << d.pselMax
+         << "), accesses under LRU " << d.accesses[0] << " (" << fixed << setprecision(2) << 100.0 * d.accesses[0] / accesses
+         << "%), under BIP " << d.accesses[1] << " (" << 100.0 * d.accesses[1] / accesses << "%), leader misses LRU "
+         << d.leaderMisses[0] << ", BIP " << d.leaderMisses[1] << endl;
+    *sim_output << "Set dueling " << name << " PSEL every " << d.interval << " accesses:";
+    for (int psel : d.trajectory)
+        *sim_output << " " << psel;
+    *sim_output << endl;
+}
+
+/**
+ * @brief Prints the ways, the blocks held, and the hits and misses of every core in a cache with partitioned ways.
+ * @param name The name of the cache in the report.
+ * @param c The cache.
+ */
+void print_partition_stats(const string &name, cache &c)
+{
+    for (size_t core = 0; core < c.quota.size(); core++)
+        print_stats("Partition " + name + " C" + to_string(core) + " ways " + to_string(c.quota[core]) + ", blocks "
+                    + to_string(c.occupancy(core)) + ",", c.coreHits[core], c.coreMisses[core]);
+}
+
+/**
+ * @brief Prints the profile of a run: the instruction mix, the hottest basic blocks with their loads, stores
+ * and share of the misses, and the jeq outcomes, each sorted by executions.
+ * @param profile The profile.
+ * @param top How many blocks and branches to print.
+ */
+void print_profile(const profiler &profile, int top)
+{
+    vector<profiler::basic_block> blocks = profile.blocks();
+    long long total = max(profile.instructions, 1LL);
+    long long allMisses[2] = {0, 0};
+    for (const profiler::basic_block &b : blocks)
+    {
+        allMisses[0] += b.misses[0];
+        allMisses[1] += b.misses[1];
+    }
+
+    *sim_output << "Profile instructions " << profile.instructions << ", basic blocks " << blocks.size() << endl;
+
+    vector<int> mnemonics;
+    for (int m = 0; m < profiler::MNEMONICS; m++)
+    {
+        if (profile.opcodes[m] > 0)
+            mnemonics.push_back(m);
+    }
+    stable_sort(mnemonics.begin(), mnemonics.end(), [&](int a, int b) { return profile.opcodes[a] > profile.opcodes[b]; });
+    for (int m : mnemonics)
+        *sim_output << "Opcode " << profiler::name(m) << " " << profile.opcodes[m] << " (" << fixed << setprecision(2)
+             << 100.0 * profile.opcodes[m] / total << "%)" << endl;
+
+    stable_sort(blocks.begin(), blocks.end(), [](const profiler::basic_block &a, const profiler::basic_block &b)
+                { return a.instructions > b.instructions; });
+    for (size_t i = 0; i < blocks.size() && (int)i < top; i++)
+    {
+        const profiler::basic_block &b = blocks[i];
+        *sim_output << "Block " << b.start << "-" << b.end << " executions " << b.executions << ", instructions "
+             << b.instructions << " (" << fixed << setprecision(2) << 100.0 * b.instructions / total << "%), loads "
+             << b.loads << ", stores " << b.stores << ", memory density "
+             << (double)(b.loads + b.stores) / max(b.instructions, 1LL) << ", L1 misses " << b.misses[0] << " ("
+             << 100.0 * b.misses[0] / max(allMisses[0], 1LL) << "%), L2 misses " << b.misses[1] << " ("
+             << 100.0 * b.misses[1] / max(allMisses[1], 1LL) << "%)" << endl;
+    }
+
+    vector<int> branches;
+    for (int pc = 0; pc < profiler::PCS; pc++)
+    {
+        if (profile.taken[pc] + profile.notTaken[pc] > 0)
+            branches.push_back(pc);
+    }
+    stable_sort(branches.begin(), branches.end(), [&](int a, int b)
+                { return profile.taken[a] + profile.notTaken[a] > profile.taken[b] + profile.notTaken[b]; });
+    for (size_t i = 0; i < branches.size() && (int)i < top; i++)
+    {
+        int pc = branches[i];
+        *sim_output << "Branch jeq pc " << pc << " taken " << profile.taken[pc] << ", not taken " << profile.notTaken[pc]
+             << " (" << fixed << setprecision(2) << 100.0 * profile.taken[pc] / (profile.taken[pc] + profile.notTaken[pc])
+             << "% taken)" << endl;
+    }
+}
+
+/**
+ * @brief Loads an analysis plugin, a shared object with an e20_plugin_init function that attaches its
+ * callbacks through the plugin_api.
+ * @param path The shared object.
+ * @return true if the plugin was loaded.
+ */
+bool load_plugin(const string &path)
+{
+    void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr)
+    {
+        *sim_errors << "Can't load plugin " << path << ": " << dlerror() << endl;
+        return false;
+    }
+
+    typedef void (*init_fn)(plugin_api *api);
+    init_fn init = (init_fn)dlsym(handle, "e20_plugin_init");
+    if (init == nullptr)
+    {
+        *sim_errors << "Plugin " << path << " has no e20_plugin_init" << endl;
+        return false;
+    }
+
+    plugin_api api = {attach_plugin};
+    init(&api);
+    return true;
+}
+
+/**
+ * @brief The arg_number function parses a number given on the command line.
+ * @param text The number.
+ * @return int the number.
+ * @throws runtime_error if text doesn't start with a number that fits an int.
+ */
+int arg_number(const string &text)
+{
+    try
+    {
+        return stoi(text);
+    }
+    catch (const invalid_argument &)
+    {
+    }
+    catch (const out_of_range &)
+    {
+    }
+    throw runtime_error("Invalid number in the arguments");
+}
+
+/**
+ * @brief Splits a comma separated cache configuration into its integer parts.
+ * @param config The configuration string, e.g. "32,2,4".
+ * @return vector<int> the parts of the configuration.
+ */
+vector<int> parse_config(const string &config)
+{
+    vector<int> parts;
+    size_t pos;
+    size_t lastpos = 0;
+    while ((pos = config.find(",", lastpos)) != string::npos)
+    {
+        parts.push_back(arg_number(config.substr(lastpos, pos)));
+        lastpos = pos + 1;
+    }
+    parts.push_back(arg_number(config.substr(lastpos)));
+    return parts;
+}
+
+/**
+ * @brief The program_images class keeps the programs already parsed, so running a program again skips the
+ * regex parsing. Files are parsed again when their modification time or size changes. It is shared by the
+ * server workers.
+ */
+class program_images
+{
+
+public:
+    typedef shared_ptr<const vector<unsigned>> image;
+
+    /**
+     * @brief A parsed program file, with the modification time and size it had when parsed.
+     */
+    struct file_image
+    {
+        long long mtime, size;
+        image cells;
+    };
+
+    size_t const static LIMIT = 4096;    // images kept of each kind, forgetting all of them beyond that.
+    mutex lock;
+    unordered_map<string, file_image> files; // path -> parsed file.
+    unordered_map<string, image> sent;       // image text sent by a client -> parsed image.
+
+    /**
+     * @brief The parse function parses the text of a program into a memory image.
+     * @param text The machine code.
+     * @return image the memory image.
+     */
+    image parse(const string &text)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            auto it = sent.find(text);
+            if (it != sent.end())
+                return it->second;
+        }
+
+        istringstream f(text);
+        shared_ptr<vector<unsigned>> cells = make_shared<vector<unsigned>>(MEM_SIZE, 0);
+        load_machine_code(f, cells->data());
+
+        lock_guard<mutex> guard(lock);
+        if (sent.size() >= LIMIT)
+            sent.clear();
+        sent[text] = cells;
+        return cells;
+    }
+
+    /**
+     * @brief The read function parses a program as it arrives on a stream, without keeping it.
+     * @param in The stream.
+     * @return image the memory image.
+     */
+    image read(istream &in)
+    {
+        shared_ptr<vector<unsigned>> cells = make_shared<vector<unsigned>>(MEM_SIZE, 0);
+        load_machine_code(in, cells->data());
+        return cells;
+    }
+
+    /**
+     * @brief The load function returns the memory image of a program file, parsing it if it changed.
+     * @param path The path of the file.
+     * @param name The file name given by the user, for the error message.
+     * @return image the memory image.
+     */
+    image load(const string &path, const string &name)
+    {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+            throw runtime_error("Can't open file " + name);
+        long long mtime = info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+
+        {
+            lock_guard<mutex> guard(lock);
+            auto it = files.find(path);
+            if (it != files.end() && it->second.mtime == mtime && it->second.size == info.st_size)
+                return it->second.cells;
+        }
+
+        ifstream f(path);
+        if (!f.is_open())
+            throw runtime_error("Can't open file " + name);
+        shared_ptr<vector<unsigned>> cells = make_shared<vector<unsigned>>(MEM_SIZE, 0);
+        load_machine_code(f, cells->data());
+
+        lock_guard<mutex> guard(lock);
+        if (files.size() >= LIMIT)
+            files.clear();
+        files[path] = {mtime, (long long)info.st_size, cells};
+        return cells;
+    }
+};
+
+/**
+ * @brief The sim_resources struct holds what a run can reuse from the runs before it: the processor, the
+ * caches, and the parsed programs. The command line makes one for its only run, and the server keeps one
+ * per worker.
+ */
+struct sim_resources
+{
+    e20_processor processor;
+    cache_pool caches;
+    program_images *images;
+    bool allowPlugins; // plugins are global to the process, so server jobs can't load them.
+
+    sim_resources(program_images *programs, bool plugins)
+    {
+        images = programs;
+        allowPlugins = plugins;
+    }
+};
+
+/**
+ * @brief The binlog_output struct sends everything a run prints to a binary log for as long as it lives,
+ * writing the footer of the log when it goes away.
+ */
+struct binlog_output
+{
+    ofstream file;
+    binlog_writer writer;
+    ostream stream;
+    ostream *saved; // where the output went before.
+
+    binlog_output(const string &path, long long block) : file(path, ios::binary), writer(file, block), stream(&writer)
+    {
+        saved = sim_output;
+        sim_output = &stream;
+        sim_binlog = &writer;
+    }
+
+    ~binlog_output()
+    {
+        writer.close();
+        sim_output = saved;
+        sim_binlog = nullptr;
+    }
+};
+
+/**
+ * @brief The simulate function runs one job: it parses the command line arguments of the job, loads the
+ * program, and simulates it, printing to sim_output and sim_errors.
+ * @param job The job, with the arguments given on the command line.
+ * @param res What the run may reuse.
+ * @return int the exit status.
+ */
+int simulate(const job_request &job, sim_resources &res)
+{
+
+    /*
+        Parse the command-line arguments
+    */
+    const vector<string> &args = job.args;
+    string filename;
+    bool do_help = false;
+    bool arg_error = false;
+    bool ext_mem = false;
+    bool unified = false;
+    bool log_fetch = false;
+    int num_cores = 1;
+    int sample_every = 1;
+    bool sample_hash = false;
+    bool sample_validate = false;
+    bool vipt = false;
+    bool close_page = false;
+    bool replay = false;
+    bool dip = false;
+    long long binlog_block = 4096;
+    int core_reg = -1;
+    string cache_config, icache_config, core_pcs, timing_config, mshr_config, way_predict, tlb_config, dram_config, binlog_path;
+    string sector_config, profile_path, partition_config;
+    int profile_top = 10;
+    vector<string> plugin_paths;
+    for (size_t i = 1; i < args.size(); i++)
+    {
+        const string &arg = args[i];
+        if (arg.rfind("-", 0) == 0 && arg != "-") // a lone - is standard input.
+        {
+            if (arg == "-h" || arg == "--help")
+                do_help = true;
+            else if (arg == "--ext-mem")
+                ext_mem = true;
+            else if (arg == "--unified")
+                unified = true;
+            else if (arg == "--log-fetch")
+                log_fetch = true;
+            else if (arg == "--sample-hash")
+                sample_hash = true;
+            else if (arg == "--sample-validate")
+                sample_validate = true;
+            else if (arg == "--vipt")
+                vipt = true;
+            else if (arg == "--close-page")
+                close_page = true;
+            else if (arg == "--replay")
+                replay = true;
+            else if (arg == "--dip")
+                dip = true;
+            else if (arg == "--sample")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    sample_every = arg_number(args[i]);
+            }
+            else if (arg == "--cache")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    cache_config = args[i];
+            }
+            else if (arg == "--cores" || arg == "--core-reg")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else if (arg == "--cores")
+                    num_cores = arg_number(args[i]);
+                else
+                    core_reg = arg_number(args[i]);
+            }
+            else if (arg == "--core-pc")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    core_pcs = args[i];
+            }
+            else if (arg == "--timing")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    timing_config = args[i];
+            }
+            else if (arg == "--binlog" || arg == "--binlog-block")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else if (arg == "--binlog")
+                    binlog_path = args[i];
+                else
+                    binlog_block = arg_number(args[i]);
+            }
+            else if (arg == "--dram")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    dram_config = args[i];
+            }
+            else if (arg == "--tlb")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    tlb_config = args[i];
+            }
+            else if (arg == "--mshr")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    mshr_config = args[i];
+            }
+            else if (arg == "--profile" || arg == "--profile-top")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else if (arg == "--profile")
+                    profile_path = args[i];
+                else
+                    profile_top = arg_number(args[i]);
+            }
+            else if (arg == "--partition")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    partition_config = args[i];
+            }
+            else if (arg == "--sector")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    sector_config = args[i];
+            }
+            else if (arg == "--way-predict")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    way_predict = args[i];
+            }
+            else if (arg == "--plugin")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    plugin_paths.push_back(args[i]);
+            }
+            else if (arg == "--icache")
+            {
+                i++;
+                if (i >= args.size())
+                    arg_error = true;
+                else
+                    icache_config = args[i];
+            }
+            else
+                arg_error = true;
+        }
+        else
+        {
+            if (filename.empty())
+                filename = args[i];
+            else
+                arg_error = true;
+        }
+    }
+    /* Display error message if appropriate */
+    if (unified && icache_config.size() > 0) // cache 1 is either split or unified.
+        arg_error = true;
+
+    if (num_cores < 1 || core_reg == 0 || core_reg >= (int)NUM_REGS)
+        arg_error = true;
+
+    if (vipt && tlb_config.empty())
+        arg_error = true;
+
+    if (close_page && dram_config.empty())
+        arg_error = true;
+
+    if (binlog_block < 1 || profile_top < 0)
+        arg_error = true;
+
+    // a trace has no instructions to fetch, profile, or spread over cores.
+    if (replay && (num_cores > 1 || unified || icache_config.size() > 0 || log_fetch || profile_path.size() > 0))
+        arg_error = true;
+
+    if (way_predict.size() > 0 && way_predict != "mru" && way_predict != "pc")
+        arg_error = true;
+
+    if (sample_every < 1 || ((sample_hash || sample_validate) && sample_every == 1))
+        arg_error = true;
+
+    if (arg_error || do_help || filename.empty())
+    {
+        *sim_errors << "usage " << args[0] << " [-h] [--cache CACHE] [--icache ICACHE | --unified] [--log-fetch] [--ext-mem]" << endl
+             << "       [--cores N [--core-pc PCS] [--core-reg REG]] [--timing LAT] [--mshr MSHR]" << endl
+             << "       [--dram DRAM [--close-page]] [--tlb TLB [--vipt]]" << endl
+             << "       [--sample N [--sample-hash] [--sample-validate]] [--way-predict MODE] [--sector SECTOR]" << endl
+             << "       [--plugin PLUGIN] [--binlog FILE [--binlog-block N]] [--profile FILE [--profile-top N]]" << endl
+             << "       [--dip] [--partition WAYS] [--replay] filename" << endl
+             << endl;
+        *sim_errors << "Simulate E20 cache" << endl
+             << endl;
+        *sim_errors << "positional arguments:" << endl;
+        *sim_errors << "  filename    The file containing machine code, typically with .bin suffix," << endl
+             << "              or - for standard input" << endl
+             << endl;
+        *sim_errors << "optional arguments:" << endl;
+        *sim_errors << "  -h, --help  show this help message and exit" << endl;
+        *sim_errors << "  --cache CACHE  Cache configuration: size,associativity,blocksize (for one" << endl;
+        *sim_errors << "                 cache) or" << endl;
+        *sim_errors << "                 size,associativity,blocksize,size,associativity,blocksize" << endl;
+        *sim_errors << "                 (for two caches)" << endl;
+        *sim_errors << "  --icache ICACHE  Split cache 1: a separate instruction cache with" << endl;
+        *sim_errors << "                 configuration size,associativity,blocksize, sharing cache 2" << endl;
+        *sim_errors << "                 with the data" << endl;
+        *sim_errors << "  --unified      Unified cache 1: instruction fetches go through the data" << endl;
+        *sim_errors << "                 cache" << endl;
+        *sim_errors << "  --log-fetch    Print a log entry for every instruction fetch" << endl;
+        *sim_errors << "  --ext-mem      Extended address mode: the segment register (set with" << endl;
+        *sim_errors << "                 setseg) selects a 64K segment of sparse paged memory" << endl;
+        *sim_errors << "  --cores N      Run N cores over one memory image, each with a private" << endl;
+        *sim_errors << "                 cache 1 kept coherent with MESI and a shared cache 2" << endl;
+        *sim_errors << "  --core-pc PCS  Comma separated starting program counter of every core" << endl;
+        *sim_errors << "  --core-reg REG Start every core with its core number in register REG" << endl;
+        *sim_errors << "  --timing LAT   Count cycles with latencies L1,L2,memory; a miss stalls" << endl;
+        *sim_errors << "                 the core until it is served" << endl;
+        *sim_errors << "  --mshr MSHR    Non-blocking caches with N or N,M miss status holding" << endl;
+        *sim_errors << "                 registers for cache 1 and cache 2 (implies --timing 1,10,100)" << endl;
+        *sim_errors << "  --dram DRAM    Main memory of channels,banks,rowsize and optionally the" << endl;
+        *sim_errors << "                 CL,RCD,RP cycles (default 20,20,20) in place of a fixed memory" << endl;
+        *sim_errors << "                 latency, with open rows served first (implies --timing 1,10,100)" << endl;
+        *sim_errors << "  --close-page   Precharge the row after every DRAM access" << endl;
+        *sim_errors << "  --tlb TLB      Translate data addresses: pagesize,entries,associativity of" << endl;
+        *sim_errors << "                 the L1 TLB, and optionally entries,associativity of an L2" << endl;
+        *sim_errors << "                 TLB; associativity 0 is fully associative" << endl;
+        *sim_errors << "  --vipt         Cache 1 is virtually indexed, physically tagged: the TLB" << endl;
+        *sim_errors << "                 lookup overlaps it, but it must fit its sets in a page" << endl;
+        *sim_errors << "  --sample N     Approximate mode: simulate one in every N sets of the last" << endl;
+        *sim_errors << "                 cache and estimate its miss rate with a confidence interval" << endl;
+        *sim_errors << "  --sample-hash  Pick the sampled sets by a hash instead of every Nth set" << endl;
+        *sim_errors << "  --sample-validate  Also run the full model and report the estimation error" << endl;
+        *sim_errors << "  --way-predict MODE  Count how often the block an access hits is predicted" << endl;
+        *sim_errors << "                 by the most recently used block of the set (mru) or by the" << endl;
+        *sim_errors << "                 pc of the access (pc)" << endl;
+        *sim_errors << "  --sector SECTOR  Sectored blocks: cells per sector of cache 1, and optionally" << endl;
+        *sim_errors << "                 of cache 2; a miss fetches only the sector of the access" << endl;
+        *sim_errors << "  --dip          Set dueling in the last cache: leader sets insert as LRU or" << endl;
+        *sim_errors << "                 bimodal (BIP), and the other sets follow the one missing less" << endl;
+        *sim_errors << "  --partition WAYS  Comma separated ways of the shared cache 2 every core" << endl;
+        *sim_errors << "                 may fill, adding up to its associativity (with --cores)" << endl;
+        *sim_errors << "  --plugin PLUGIN  Load a shared object analysis plugin that receives every" << endl;
+        *sim_errors << "                 cache event, may be given more than once" << endl;
+        *sim_errors << "  --binlog FILE  Write the output to FILE as a compact binary log, read it back" << endl;
+        *sim_errors << "                 with --decode FILE [--from N] [--count M]" << endl;
+        *sim_errors << "  --binlog-block N  Records per seekable block of the binary log (default 4096)" << endl;
+        *sim_errors << "  --profile FILE  Profile the program: print the instruction mix, the hottest" << endl;
+        *sim_errors << "                 basic blocks and the jeq outcomes, and write every count to FILE" << endl;
+        *sim_errors << "                 as JSON" << endl;
+        *sim_errors << "  --profile-top N  Basic blocks and branches in the profile report (default 10)" << endl;
+        *sim_errors << "  --replay       filename is an address trace to run through the data caches" << endl;
+        *sim_errors << "                 in place of a program: lines of R or W, an address, and" << endl;
+        *sim_errors << "                 optionally a pc" << endl;
+        return 1;
+    }
+
+    if (!res.allowPlugins && plugin_paths.size() > 0)
+    {
+        *sim_errors << "Plugins can't be loaded by server jobs" << endl;
+        return 1;
+    }
+
+    unique_ptr<binlog_output> binlog; // every later output goes to the binary log.
+    if (binlog_path.size() > 0)
+    {
+        if (job.cwd.size() > 0 && binlog_path[0] != '/')
+            binlog_path = job.cwd + "/" + binlog_path;
+        binlog.reset(new binlog_output(binlog_path, binlog_block));
+        if (!binlog->file.is_open())
+        {
+            *sim_errors << "Can't open file " << binlog_path << endl;
+            return 1;
+        }
+    }
+
+    unique_ptr<profiler> profile; // shared by every core.
+    ofstream profile_file;
+    if (profile_path.size() > 0)
+    {
+        if (job.cwd.size() > 0 && profile_path[0] != '/')
+            profile_path = job.cwd + "/" + profile_path;
+        profile_file.open(profile_path);
+        if (!profile_file.is_open())
+        {
+            *sim_errors << "Can't open file " << profile_path << endl;
+            return 1;
+        }
+        profile.reset(new profiler(num_cores));
+    }
+
+    if (filename == "-" && job.image.empty() && sim_input == nullptr)
+    {
+        *sim_errors << "Server jobs can't read standard input" << endl;
+        return 1;
+    }
+
+    unique_ptr<istream> trace_file; // the address trace of a replay, read as the run goes.
+    istream *trace = nullptr;
+    shared_ptr<const vector<unsigned>> image;
+    if (replay)
+    {
+        image = make_shared<vector<unsigned>>(MEM_SIZE, 0);
+        if (job.image.size() > 0)
+            trace_file.reset(new istringstream(job.image));
+        else if (filename != "-")
+            trace_file.reset(new ifstream((job.cwd.size() > 0 && filename[0] != '/') ? job.cwd + "/" + filename : filename));
+        trace = trace_file ? trace_file.get() : sim_input;
+        if (!*trace)
+        {
+            *sim_errors << "Can't open file " << filename << endl;
+            return 1;
+        }
+    }
+    else if (job.image.size() > 0)
+        image = res.images->parse(job.image);
+    else if (filename == "-")
+        image = res.images->read(*sim_input);
+    else if (job.cwd.size() > 0 && filename[0] != '/') // relative to the client.
+        image = res.images->load(job.cwd + "/" + filename, filename);
+    else
+        image = res.images->load(filename, filename);
+
+    for (const string &path : plugin_paths)
+    {
+        if (!load_plugin(path))
+            return 1;
+    }
+
+    e20_processor &instuction = res.processor; // reusing the e20 processor of earlier runs.
+    instuction.reset();
+    instuction.extended = ext_mem;
+
+    copy(image->begin(), image->end(), instuction.memory);
+
+    int numLinesL1, L1size, L1assoc, L1blocksize;
+    int numLinesL2 = 1, L2size = 0, L2assoc = 1, L2blocksize = 1; // unused placeholders for one cache.
+    bool isTwoCache;
+
+    /* parse cache config */
+    if (cache_config.size() > 0)
+    {
+        vector<int> parts = parse_config(cache_config);
+        for (size_t i = 0; i + 2 < parts.size(); i += 3)
+        {
+            if (!valid_cache(parts[i], parts[i + 1], parts[i + 2]))
+                parts.clear();
+        }
+
+        if (parts.size() == 3)
+        {
+            L1size = parts[0];
+            L1assoc = parts[1];
+            L1blocksize = parts[2];
+            isTwoCache = false;
+
+            one_cache(L1assoc, L1size, L1blocksize, numLinesL1); //sets cache 1 configrations.
+        }
+        else if (parts.size() == 6)
+        {
+
+            L1size = parts[0];
+            L1assoc = parts[1];
+            L1blocksize = parts[2];
+            L2size = parts[3];
+            L2assoc = parts[4];
+            L2blocksize = parts[5];
+            isTwoCache = true;
+             
+            //sets cache 1 and 2 configrations.
+            two_cache(L1assoc, L2assoc, numLinesL1, numLinesL2, L1size, L2size, L1blocksize, L2blocksize);
+        }
+        else
+        {
+            *sim_errors << "Invalid cache config" << endl;
+            return 1;
+        }
+  
+        int numLinesI = 1, Isize = 1, Iassoc = 1, Iblocksize = 1;
+
+        if (icache_config.size() > 0)
+        {
+            vector<int> iparts = parse_config(icache_config);
+            if (iparts.size() != 3 || !valid_cache(iparts[0], iparts[1], iparts[2]))
+            {
+                *sim_errors << "Invalid instruction cache config" << endl;
+                return 1;
+            }
+
+            Isize = iparts[0];
+            Iassoc = iparts[1];
+            Iblocksize = iparts[2];
+            numLinesI = (Iassoc == 1) ? Isize / Iblocksize : Isize / (Iblocksize * Iassoc);
+            print_cache_config("L1I", Isize, Iassoc, Iblocksize, numLinesI);
+        }
+
+        cache &l1 = res.caches.take(numLinesL1, L1blocksize, L1assoc);  // Cache 1.
+        cache &l2 = res.caches.take(numLinesL2, L2blocksize, L2assoc);  // Cache 2.
+        cache &il1 = res.caches.take(numLinesI, Iblocksize, Iassoc);    // the instruction Cache 1.
+        l2.level = 2;
+
+        /* parse sector config */
+        if (sector_config.size() > 0)
+        {
+            vector<int> sectors = parse_config(sector_config);
+            bool valid = sectors.size() == 1 || (sectors.size() == 2 && isTwoCache);
+            for (size_t c = 0; c < sectors.size() && valid; c++)
+            {
+                int blockSize = (c == 0) ? L1blocksize : L2blocksize;
+                valid = sectors[c] >= 1 && blockSize % sectors[c] == 0 && blockSize / sectors[c] <= 64;
+            }
+            if (!valid)
+            {
+                *sim_errors << "Invalid sector config" << endl;
+                return 1;
+            }
+            if (sectors[0] < L1blocksize)
+                l1.set_sectors(sectors[0]);
+            if (sectors.size() == 2 && sectors[1] < L2blocksize)
+                l2.set_sectors(sectors[1]);
+        }
+
+        cache &last = isTwoCache ? l2 : l1;           // the sampled cache.
+        cache &full = res.caches.take(last.numLine, last.blockSize, last.associate);
+        full.observed = false; // the validation model is not reported to plugins.
+        if (last.sectorSize > 0)
+            full.set_sectors(last.sectorSize);
+
+        set_dueling dueling(max(last.numLine, 2)); // of the last cache.
+        if (dip)
+        {
+            if (last.associate < 2 || last.numLine < 2 || (num_cores > 1 && !isTwoCache))
+            {
+                *sim_errors << "Set dueling needs a shared associative cache with at least two sets" << endl;
+                return 1;
+            }
+            last.dueling = &dueling;
+        }
+
+        /* parse partition config */
+        if (partition_config.size() > 0)
+        {
+            vector<int> ways = parse_config(partition_config);
+            int total = 0;
+            for (int w : ways)
+                total += (w < 1) ? L2assoc + 1 : w;
+            if (!isTwoCache || (int)ways.size() != num_cores || num_cores < 2 || L2assoc < 2 || total != L2assoc)
+            {
+                *sim_errors << "Invalid partition config" << endl;
+                return 1;
+            }
+            l2.set_partition(ways);
+        }
+        set_sampler sampler (last.numLine, sample_every, sample_hash);
+        if (sample_every > 1)
+        {
+            last.sampler = &sampler;
+            if (sample_validate)
+                sampler.full = &full;
+        }
+
+        deque<pair<string, way_predictor>> predictors; // way predictors of the associative caches.
+        bool by_pc = way_predict == "pc";
+
+        /* parse timing config */
+        vector<int> latencies = {1, 10, 100};
+        vector<int> mshrs;
+        if (timing_config.size() > 0)
+            latencies = parse_config(timing_config);
+        if (mshr_config.size() > 0)
+            mshrs = parse_config(mshr_config);
+        if (latencies.size() != 3 || mshrs.size() > 2 || (mshrs.size() > 0 && (mshrs[0] < 1 || mshrs.back() < 1)))
+        {
+            *sim_errors << "Invalid timing config" << endl;
+            return 1;
+        }
+        /* parse DRAM config */
+        vector<int> drams = {1, 1, 1, 20, 20, 20};
+        if (dram_config.size() > 0)
+        {
+            vector<int> parts = parse_config(dram_config);
+            copy(parts.begin(), parts.begin() + min(parts.size(), drams.size()), drams.begin());
+            if ((parts.size() != 3 && parts.size() != 6) || *min_element(drams.begin(), drams.begin() + 3) < 1
+                || *min_element(drams.begin() + 3, drams.end()) < 0)
+            {
+                *sim_errors << "Invalid DRAM config" << endl;
+                return 1;
+            }
+        }
+        dram memory(drams[0], drams[1], drams[2], drams[3], drams[4], drams[5], !close_page); // shared by every core.
+
+        bool timed = timing_config.size() > 0 || mshrs.size() > 0 || dram_config.size() > 0;
+        int l1Mshrs = mshrs.empty() ? 1 : mshrs[0];
+        int l2Mshrs = mshrs.empty() ? 1 : mshrs.back();
+
+        // set sampling applies to the last cache, which must be shared when there are several cores.
+        if (sample_every > 1 && (timed || (num_cores > 1 && !isTwoCache)))
+        {
+            *sim_errors << "Set sampling estimates the miss rate of the last shared cache only, without timing" << endl;
+            return 1;
+        }
+
+        /* parse TLB config */
+        vector<int> tlbs_config = {1, 1, 1, 0, 0};
+        bool translated = tlb_config.size() > 0;
+        if (translated)
+        {
+            vector<int> parts = parse_config(tlb_config);
+            copy(parts.begin(), parts.begin() + min(parts.size(), tlbs_config.size()), tlbs_config.begin());
+
+            if ((parts.size() != 3 && parts.size() != 5) || tlbs_config[0] < 1 || tlbs_config[1] < 1 || tlbs_config[3] < 0
+                || tlbs_config[2] < 0 || tlbs_config[4] < 0 || tlbs_config[1] % tlb::ways(tlbs_config[1], tlbs_config[2]) != 0
+                || (tlbs_config[3] > 0 && tlbs_config[3] % tlb::ways(tlbs_config[3], tlbs_config[4]) != 0))
+            {
+                *sim_errors << "Invalid TLB config" << endl;
+                return 1;
+            }
+            if (sample_every > 1)
+            {
+                *sim_errors << "Set sampling can't be combined with address translation" << endl;
+                return 1;
+            }
+            if (vipt && (long long)l1.numLine * l1.blockSize > tlbs_config[0])
+            {
+                *sim_errors << "Cache 1 can't be virtually indexed: its sets times its blocksize exceed the page size" << endl;
+                return 1;
+            }
+        }
+        page_table pages(tlbs_config[0]); // shared by every core.
+        deque<tlb> tlbs;                  // TLB of every core.
+
+        if (num_cores > 1)
+        {
+            vector<int> pcs;
+            if (core_pcs.size() > 0)
+                pcs = parse_config(core_pcs);
+
+            deque<e20_processor> cores;                  // every core shares the memory of instuction.
+            vector<cache> l1s(num_cores, l1), il1s(num_cores, il1); // private caches of every core.
+            vector<cache *> buses;
+            vector<sim_context> ctxs;
+
+            for (int core = 0; core < num_cores; core++)
+            {
+                cores.emplace_back(&instuction);
+                cores[core].pc = (core < (int)pcs.size()) ? pcs[core] : 0;
+                if (core_reg > 0)
+                    cores[core].regs[core_reg] = core;
+
+                buses.push_back(&l1s[core]);
+                ctxs.emplace_back(l1s[core], l2, isTwoCache);
+                ctxs[core].core = core;
+                ctxs[core].prefix = "C" + to_string(core) + ":";
+                ctxs[core].logFetch = log_fetch;
+                ctxs[core].profile = profile.get();
+
+                if (icache_config.size() > 0)
+                    ctxs[core].il1 = &il1s[core];
+                else if (unified)
+                    ctxs[core].il1 = &l1s[core];
+            }
+
+            for (int core = 0; core < num_cores && way_predict.size() > 0; core++)
+            {
+                attach_way_predictor(predictors, ctxs[core].prefix + "L1", l1s[core], by_pc);
+                if (icache_config.size() > 0)
+                    attach_way_predictor(predictors, ctxs[core].prefix + "L1I", il1s[core], by_pc);
+            }
+            if (isTwoCache && way_predict.size() > 0)
+                attach_way_predictor(predictors, "Shared L2", l2, by_pc);
+
+            for (int core = 0; core < num_cores && translated; core++)
+            {
+                tlbs.emplace_back(tlbs_config[1], tlbs_config[2], tlbs_config[3], tlbs_config[4], &pages);
+                ctxs[core].translation = &tlbs[core];
+                ctxs[core].vipt = vipt;
+            }
+
+            mesi_bus bus(buses);
+            for (sim_context &ctx : ctxs)
+                ctx.bus = &bus;
+
+            deque<timing_model> timings;  // cycle model of every core.
+            deque<mshr_file> l1Files;     // MSHRs of every private cache 1.
+            mshr_file l2File(l2Mshrs);    // MSHRs of the shared cache 2.
+            for (int core = 0; core < num_cores && timed; core++)
+            {
+                timings.emplace_back(latencies[0], latencies[1], latencies[2]);
+                l1Files.emplace_back(l1Mshrs);
+                timings[core].nonBlocking = mshrs.size() > 0;
+                timings[core].l1Mshr = &l1Files[core];
+                timings[core].l2Mshr = &l2File;
+                if (dram_config.size() > 0)
+                    timings[core].memory = &memory;
+                ctxs[core].timing = &timings[core];
+            }
+
+            e20MultiSim(cores, ctxs);      // Run the e20 cores.
+            print_coherence_stats(ctxs, bus);
+            if (dram_config.size() > 0)
+                print_dram_stats(memory);
+            for (int core = 0; core < num_cores && translated; core++)
+                print_tlb_stats(ctxs[core].prefix, tlbs[core], ctxs[core].timing);
+            if (translated)
+                *sim_output << "Pages mapped " << pages.frames.size() << ", page table pages " << pages.tables.size() << endl;
+            for (int core = 0; core < num_cores; core++)
+                print_sector_stats(ctxs[core].prefix + "L1", l1s[core]);
+            if (isTwoCache)
+                print_sector_stats("Shared L2", l2);
+            print_partition_stats("Shared L2", l2);
+            if (dip)
+                print_dueling_stats(isTwoCache ? "Shared L2" : "L1", dueling);
+            print_way_stats(predictors);
+            if (profile)
+            {
+                print_profile(*profile, profile_top);
+                profile->write_json(profile_file);
+            }
+            plugins().finish();
+
+            if (sample_every > 1)
+                print_sampling_stats("L2", sampler);
+            return 0;
+        }
+
+        sim_context ctx(l1, l2, isTwoCache);
+        ctx.logFetch = log_fetch;
+        ctx.profile = profile.get();
+
+        if (icache_config.size() > 0)
+            ctx.il1 = &il1;
+        else if (unified)
+            ctx.il1 = &l1;
+
+        timing_model timing(latencies[0], latencies[1], latencies[2]);
+        mshr_file l1File(l1Mshrs), l2File(l2Mshrs);
+        timing.nonBlocking = mshrs.size() > 0;
+        timing.l1Mshr = &l1File;
+        timing.l2Mshr = &l2File;
+        if (dram_config.size() > 0)
+            timing.memory = &memory;
+        if (timed)
+            ctx.timing = &timing;
+
+        if (translated)
+        {
+            tlbs.emplace_back(tlbs_config[1], tlbs_config[2], tlbs_config[3], tlbs_config[4], &pages);
+            ctx.translation = &tlbs[0];
+            ctx.vipt = vipt;
+        }
+
+        if (way_predict.size() > 0)
+        {
+            attach_way_predictor(predictors, "L1", l1, by_pc);
+            if (icache_config.size() > 0)
+                attach_way_predictor(predictors, "L1I", il1, by_pc);
+            if (isTwoCache)
+                attach_way_predictor(predictors, "L2", l2, by_pc);
+        }
+      
+        if (replay)
+            replay_trace(*trace, instuction, ctx);
+        else
+            e20Sim(instuction, ctx);      // Run the e20 processor.
+
+        if (ctx.il1 != nullptr)
+            print_fetch_stats(ctx);
+
+        if (timed)
+            print_timing_stats("", timing, isTwoCache);
+
+        if (dram_config.size() > 0)
+            print_dram_stats(memory);
+
+        if (translated)
+        {
+            print_tlb_stats("", tlbs[0], ctx.timing);
+            *sim_output << "Pages mapped " << pages.frames.size() << ", page table pages " << pages.tables.size() << endl;
+        }
+
+        print_sector_stats("L1", l1);
+        if (isTwoCache)
+            print_sector_stats("L2", l2);
+
+        if (dip)
+            print_dueling_stats(isTwoCache ? "L2" : "L1", dueling);
+
+        print_way_stats(predictors);
+
+        if (profile)
+        {
+            print_profile(*profile, profile_top);
+            profile->write_json(profile_file);
+        }
+
+        if (sample_every > 1)
+            print_sampling_stats(isTwoCache ? "L2" : "L1", sampler);
+
+        plugins().finish();
+
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief The run_job function runs a job on pooled resources, turning any error into an exit status.
+ * @param job The job.
+ * @param res What the run may reuse.
+ * @return int the exit status.
+ */
+int run_job(const job_request &job, sim_resources &res)
+{
+    res.caches.release(); // the caches of the last run are free again.
+    try
+    {
+        return simulate(job, res);
+    }
+    catch (const exception &e)
+    {
+        *sim_errors << e.what() << endl;
+        return 1;
+    }
+}
+
+// bench.cpp includes the simulator without its main.
+#ifndef E20_NO_MAIN
+
+/**
+ * @brief The serve_jobs function runs the server: simcache --serve SOCKET [--workers N]
+ * @param args The command line arguments.
+ * @return int 1 if the server can't start.
+ */
+int serve_jobs(const vector<string> &args)
+{
+    long long workers = thread::hardware_concurrency();
+    if (args.size() == 5 && args[3] == "--workers")
+    {
+        if (!trace_number(args[4], workers) || workers > numeric_limits<int>::max())
+            workers = 0;
+    }
+    else if (args.size() != 3)
+        workers = 0;
+
+    if (workers < 1)
+    {
+        cerr << "usage " << args[0] << " --serve SOCKET [--workers N]" << endl;
+        return 1;
+    }
+
+    program_images images; // shared by every worker.
+    deque<sim_resources> pools;
+    for (int worker = 0; worker < workers; worker++)
+        pools.emplace_back(&images, false);
+
+    return serve(args[2], workers, [&](const job_request &request, job_reply &reply, int worker) {
+        ostringstream out, err;
+        sim_output = &out;
+        sim_errors = &err;
+        sim_input = nullptr;
+        reply.status = run_job(request, pools[worker]);
+        reply.out = out.str();
+        reply.err = err.str();
+    });
+}
+
+/**
+ * @brief Reads a whole file.
+ * @param path The file.
+ * @param text The contents.
+ * @return true if the file was read.
+ */
+bool read_file(const string &path, string &text)
+{
+    ifstream f(path, ios::binary);
+    if (!f.is_open())
+        return false;
+    ostringstream contents;
+    contents << f.rdbuf();
+    text = contents.str();
+    return true;
+}
+
+/**
+ * @brief The run_client function sends jobs to a server in place of running them:
+ * simcache --client SOCKET [--send-image] ARGS... runs the job given by ARGS, and
+ * simcache --client SOCKET --batch runs one job per line of standard input.
+ * With --send-image the client reads the program, the last argument, and sends it with the job, as it
+ * does with standard input when the last argument is -.
+ * @param args The command line arguments.
+ * @return int the exit status of the job, or 1 if a job of the batch failed.
+ */
+int run_client(const vector<string> &args)
+{
+    int fd = connect_server(args[2]);
+    if (fd < 0)
+    {
+        cerr << "Can't connect to server " << args[2] << endl;
+        return 1;
+    }
+    socket_stream stream(fd);
+
+    char dir[4096];
+    job_request request;
+    request.cwd = getcwd(dir, sizeof(dir)) ? dir : "";
+
+    bool batch = args.size() > 3 && args[3] == "--batch";
+    bool send_image = args.size() > 3 && args[3] == "--send-image";
+    vector<vector<string>> jobs;
+
+    if (batch)
+    {
+        string line;
+        while (getline(cin, line))
+        {
+            istringstream words(line);
+            vector<string> job = {args[0]};
+            string word;
+            while (words >> word)
+                job.push_back(word);
+            if (job.size() > 1)
+                jobs.push_back(job);
+        }
+    }
+    else
+    {
+        jobs.push_back({args[0]});
+        jobs[0].insert(jobs[0].end(), args.begin() + (send_image ? 4 : 3), args.end());
+    }
+
+    int status = 0;
+    job_reply reply;
+    for (vector<string> &job : jobs)
+    {
+        request.args = job;
+        request.image = "";
+        if (!batch && job.back() == "-") // the program or trace comes from our standard input.
+        {
+            ostringstream contents;
+            contents << cin.rdbuf();
+            request.image = contents.str();
+        }
+        else if (send_image && job.size() > 1 && !read_file(job.back(), request.image))
+        {
+            cerr << "Can't open file " << job.back() << endl;
+            return 1;
+        }
+
+        if (!write_request(stream, request) || !read_reply(stream, reply))
+        {
+            cerr << "Lost connection to server " << args[2] << endl;
+            return 1;
+        }
+        cout << reply.out << flush;
+        cerr << reply.err << flush;
+        status = batch ? max(status, (int)(reply.status != 0)) : reply.status;
+    }
+    close(fd);
+    return status;
+}
+
+/**
+ * @brief The decode_log function prints a binary log as the text the run would have printed:
+ * simcache --decode FILE [--from N] [--count M] prints M records starting from record N, seeking to the
+ * block holding it. Without --from the log is read as a stream, so FILE may be a pipe.
+ * @param args The command line arguments.
+ * @return int 1 if the log can't be read.
+ */
+int decode_log(const vector<string> &args)
+{
+    long long from = 0, count = -1;
+    bool parsed = args.size() % 2 == 1;
+    for (size_t i = 3; parsed && i + 1 < args.size(); i += 2)
+    {
+        if (args[i] == "--from")
+            parsed = trace_number(args[i + 1], from);
+        else if (args[i] == "--count")
+            parsed = trace_number(args[i + 1], count);
+        else
+            parsed = false;
+    }
+    if (!parsed)
+    {
+        cerr << "usage " << args[0] << " --decode FILE [--from N] [--count M]" << endl;
+        return 1;
+    }
+
+    ifstream f(args[2], ios::binary);
+    binlog_reader reader(f);
+    if (!f.is_open() || !reader.ok || (from > 0 && !reader.seek(from)))
+    {
+        cerr << "Can't read binary log " << args[2] << endl;
+        return 1;
+    }
+
+    ostringstream chunk; // print in chunks rather than flushing every line.
+    sim_output = &chunk;
+    binlog_record r;
+    long long printed = 0;
+
+    while ((count < 0 || printed < count) && reader.next(r))
+    {
+        if (reader.record <= from) // before the first record asked for, in its block.
+            continue;
+
+        if (r.kind == BL_TEXT)
+            chunk << r.text;
+        else
+            print_log_entry(r.name, r.status, r.pc, r.addr, r.line);
+
+        if (++printed % 4096 == 0)
+        {
+            cout << chunk.str();
+            chunk.str("");
+        }
+    }
+    cout << chunk.str() << flush;
+    sim_output = &cout;
+
+    if (!reader.ok)
+    {
+        cerr << "Corrupt binary log " << args[2] << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+    Main function
+    Takes command-line args as documented below
+*/
+int main(int argc, char *argv[])
+{
+    vector<string> args(argv, argv + argc);
+
+    if (argc >= 3 && args[1] == "--serve")
+        return serve_jobs(args);
+    if (argc >= 3 && args[1] == "--client")
+        return run_client(args);
+    if (argc >= 3 && args[1] == "--decode")
+        return decode_log(args);
+
+    program_images images;
+    sim_resources res(&images, true);
+    job_request job;
+    job.args = args;
+    return run_job(job, res);
+}
+
+#endif
 // ra0Eequ6ucie6Jei0koh6phishohm9
\ No newline at end of file
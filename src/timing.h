@@ -0,0 +1,305 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "dram.h"
+
+using namespace std;
+
+/**
+ * @brief The mshr_file class holds the miss status holding registers of one cache level. Each register tracks
+ * one outstanding block miss and the cycle its data returns. A secondary miss to a block that is already
+ * outstanding merges into its register, and when every register is busy a new miss has to wait.
+ */
+class mshr_file
+{
+
+public:
+    /**
+     * @brief One outstanding miss: the block, and the cycle its data is ready.
+     */
+    struct entry
+    {
+        long long block, ready;
+    };
+
+    int capacity;                // number of registers.
+    vector<entry> entries;       // outstanding misses.
+    long long primary, merges;   // misses that allocated a register, and secondary misses merged into one.
+    long long fullStalls;        // cycles spent waiting for a free register.
+    long long busyCycles;        // sum of the cycles every register was busy, for the average occupancy.
+    int peak;                    // most registers busy at once.
+
+    /**
+     * @brief The mshr file constructor starts with every register free.
+     * @param regs number of registers.
+     */
+    mshr_file(int regs)
+    {
+        capacity = regs;
+        primary = merges = fullStalls = busyCycles = 0;
+        peak = 0;
+    }
+
+    /**
+     * @brief The retire function frees the registers whose data has returned by the given cycle.
+     * @param cycle the current cycle.
+     */
+    void retire(long long cycle)
+    {
+        for (size_t i = entries.size(); i-- > 0;)
+        {
+            if (entries[i].ready <= cycle)
+                entries.erase(entries.begin() + i);
+        }
+    }
+
+    /**
+     * @brief The find function returns the outstanding miss of a block, or nullptr.
+     * @param block the blockID.
+     * @return entry* the outstanding miss.
+     */
+    entry *find(long long block)
+    {
+        for (entry &e : entries)
+        {
+            if (e.block == block)
+                return &e;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief The reserve function waits until the earliest outstanding miss returns if every register is busy.
+     * @param cycle the cycle of the miss, moved forward by a structural stall.
+     */
+    void reserve(long long &cycle)
+    {
+        retire(cycle);
+
+        if ((int)entries.size() >= capacity) // structural stall until a register frees.
+        {
+            long long earliest = entries[0].ready;
+            for (entry &e : entries)
+                earliest = min(earliest, e.ready);
+
+            fullStalls += earliest - cycle;
+            cycle = earliest;
+            retire(cycle);
+        }
+    }
+
+    /**
+     * @brief The allocate function takes a free register for a new miss, waiting for one first if every
+     * register is busy.
+     * @param block the blockID.
+     * @param cycle the cycle of the miss, moved forward by a structural stall.
+     * @param latency the cycles until the data is ready.
+     * @return long long the cycle the data is ready.
+     */
+    long long allocate(long long block, long long &cycle, long long latency)
+    {
+        reserve(cycle);
+
+        entries.push_back({block, cycle + latency});
+        primary++;
+        busyCycles += latency;
+        peak = max(peak, (int)entries.size());
+        return cycle + latency;
+    }
+};
+
+/**
+ * @brief The timing_model class counts the cycles of one core. Every instruction issues in one cycle and
+ * loads deliver their data after the latency of the level that served them. In the blocking model a miss
+ * stalls the core until it is served. In the non-blocking model misses go to the MSHRs and the core keeps
+ * issuing until an instruction needs a register whose load has not returned.
+ */
+class timing_model
+{
+
+public:
+    int l1Latency, l2Latency, memLatency; // access latency of cache 1, cache 2, and memory.
+    bool nonBlocking;                     // lockup-free caches with MSHRs.
+    mshr_file *l1Mshr, *l2Mshr;           // MSHRs of cache 1 and cache 2, l2Mshr may be shared by cores.
+    long long cycle, instructions;
+    long long regReady[8];                // cycle the value of every register is ready.
+    long long useStalls, missStalls;      // cycles waiting on a register, and on a blocking miss.
+    long long lastReady;                  // cycle the data of the last load is ready.
+    long long translationStalls;          // cycles spent translating addresses: TLB lookups and page walks.
+    dram *memory;                         // main memory model, nullptr for a fixed memory latency.
+
+    /**
+     * @brief The timing model constructor sets the latencies of each level.
+     * @param l1 cache 1 latency.
+     * @param l2 cache 2 latency.
+     * @param mem memory latency.
+     */
+    timing_model(int l1, int l2, int mem)
+    {
+        l1Latency = l1;
+        l2Latency = l2;
+        memLatency = mem;
+        nonBlocking = false;
+        l1Mshr = l2Mshr = nullptr;
+        cycle = instructions = 0;
+        useStalls = missStalls = lastReady = 0;
+        translationStalls = 0;
+        memory = nullptr;
+        for (long long &ready : regReady)
+            ready = 0;
+    }
+
+    /**
+     * @brief The wait_for function stalls the core until a register is ready.
+     * @param reg the register.
+     */
+    void wait_for(unsigned reg)
+    {
+        if (regReady[reg] > cycle)
+        {
+            useStalls += regReady[reg] - cycle;
+            cycle = regReady[reg];
+        }
+    }
+
+    /**
+     * @brief The memory_latency function returns the cycles main memory takes to serve a read.
+     * @param address the memory address.
+     * @param arrival the cycle the read reaches memory.
+     * @return long long the latency.
+     */
+    long long memory_latency(long long address, long long arrival)
+    {
+        if (memory == nullptr)
+            return memLatency;
+        return memory->access(address, arrival);
+    }
+
+    /**
+     * @brief The miss_latency function returns the cycles to serve a cache 1 miss starting this cycle.
+     * @param isTwoCache if wether we have 2 caches.
+     * @param l2Hit if cache 2 hit.
+     * @param address the memory address.
+     * @return long long the latency.
+     */
+    long long miss_latency(bool isTwoCache, bool l2Hit, long long address)
+    {
+        if (!isTwoCache)
+            return l1Latency + memory_latency(address, cycle + l1Latency);
+        if (l2Hit)
+            return l1Latency + l2Latency;
+        return l1Latency + l2Latency + memory_latency(address, cycle + l1Latency + l2Latency);
+    }
+
+    /**
+     * @brief The fetch function stalls the core for an instruction cache miss. Fetch is always blocking.
+     * @param l1Hit if the instruction cache hit.
+     * @param isTwoCache if wether we have 2 caches.
+     * @param l2Hit if cache 2 hit.
+     * @param address the address of the instruction.
+     */
+    void fetch(bool l1Hit, bool isTwoCache, bool l2Hit, long long address)
+    {
+        if (!l1Hit)
+        {
+            long long stall = miss_latency(isTwoCache, l2Hit, address) - l1Latency;
+            missStalls += stall;
+            cycle += stall;
+        }
+    }
+
+    /**
+     * @brief The translate function stalls the core while an address is translated. Page walks are blocking.
+     * @param cycles the cycles the translation takes.
+     */
+    void translate(long long cycles)
+    {
+        translationStalls += cycles;
+        cycle += cycles;
+    }
+
+    /**
+     * @brief The load function works out when the data of a load is ready and saves it in lastReady.
+     * A functional hit on a block that is still outstanding, in cache 1 or in cache 2, is a secondary miss
+     * that merges into its MSHR.
+     * @param l1Block cache 1 blockID.
+     * @param l1Hit if cache 1 hit.
+     * @param isTwoCache if wether we have 2 caches.
+     * @param l2Block cache 2 blockID.
+     * @param l2Hit if cache 2 hit.
+     * @param address the memory address.
+     */
+    void load(long long l1Block, bool l1Hit, bool isTwoCache, long long l2Block, bool l2Hit, long long address)
+    {
+        if (!nonBlocking)
+        {
+            lastReady = cycle + (l1Hit ? l1Latency : miss_latency(isTwoCache, l2Hit, address));
+            if (!l1Hit) // the core stalls until the miss is served.
+            {
+                missStalls += lastReady - cycle;
+                cycle = lastReady;
+            }
+            return;
+        }
+
+        l1Mshr->retire(cycle);
+        mshr_file::entry *pending = l1Mshr->find(l1Block);
+
+        if (pending != nullptr) // secondary miss.
+        {
+            l1Mshr->merges++;
+            lastReady = pending->ready;
+        }
+        else if (l1Hit)
+        {
+            lastReady = cycle + l1Latency;
+        }
+        else if (isTwoCache) // the miss goes on to cache 2, where its block may still be on its way from memory.
+        {
+            l1Mshr->reserve(cycle); // cache 2 sees the miss once cache 1 has a register.
+            l2Mshr->retire(cycle);
+            mshr_file::entry *l2Pending = l2Mshr->find(l2Block);
+            long long l2Ready;
+
+            if (l2Pending != nullptr) // a functional hit or miss on a block cache 2 is still filling.
+            {
+                l2Mshr->merges++;
+                l2Ready = l2Pending->ready;
+            }
+            else if (l2Hit)
+            {
+                l2Ready = cycle + miss_latency(isTwoCache, true, address);
+            }
+            else
+            {
+                l2Mshr->reserve(cycle); // memory sees the miss once it has a register.
+                l2Ready = l2Mshr->allocate(l2Block, cycle, miss_latency(isTwoCache, false, address));
+            }
+            lastReady = l1Mshr->allocate(l1Block, cycle, max(l2Ready - cycle, (long long)l1Latency));
+        }
+        else
+        {
+            l1Mshr->reserve(cycle);
+            lastReady = l1Mshr->allocate(l1Block, cycle, miss_latency(isTwoCache, l2Hit, address));
+        }
+    }
+
+    /**
+     * @brief The drain function waits for every outstanding load when the core halts.
+     */
+    void drain()
+    {
+        for (unsigned reg = 0; reg < 8; reg++)
+            wait_for(reg);
+    }
+
+    /**
+     * @brief The retire_instr function ends an instruction, taking one cycle to issue.
+     */
+    void retire_instr()
+    {
+        cycle++;
+        instructions++;
+    }
+};
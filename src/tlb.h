@@ -0,0 +1,134 @@
+#pragma once
+
+#include <unordered_map>
+#include "cache.h"
+
+using namespace std;
+
+/**
+ * @brief The page_table class maps virtual pages to physical frames, handing out frames in the order pages
+ * are first touched. The table itself is linear, one entry per virtual page, and lives in physical frames
+ * of its own that are also allocated the first time one of their entries is needed, so the page walker can
+ * read the entries through the data cache like any other memory.
+ */
+class page_table
+{
+
+public:
+    long long pageSize;                         // cells per page.
+    unordered_map<long long, long long> frames; // virtual page -> physical frame.
+    unordered_map<long long, long long> tables; // page of the table -> physical frame holding it.
+    long long nextFrame;                        // the next free physical frame.
+
+    /**
+     * @brief The page table constructor starts with nothing mapped.
+     * @param page cells per page.
+     */
+    page_table(long long page)
+    {
+        pageSize = page;
+        nextFrame = 0;
+    }
+
+    /**
+     * @brief The frame function returns the physical frame of a virtual page, mapping it on first touch.
+     * @param vpn the virtual page number.
+     * @return long long the physical frame number.
+     */
+    long long frame(long long vpn)
+    {
+        auto it = frames.find(vpn);
+        if (it != frames.end())
+            return it->second;
+        return frames[vpn] = nextFrame++;
+    }
+
+    /**
+     * @brief The entry_address function returns the physical address of the entry of a virtual page.
+     * @param vpn the virtual page number.
+     * @return long long the physical address the page walker reads.
+     */
+    long long entry_address(long long vpn)
+    {
+        long long page = vpn / pageSize;
+        auto it = tables.find(page);
+        long long ppn = (it != tables.end()) ? it->second : (tables[page] = nextFrame++);
+        return ppn * pageSize + vpn % pageSize;
+    }
+};
+
+/**
+ * @brief The tlb class is the translation lookaside buffer of a core, a set-associative L1 TLB and an optional
+ * L2 TLB. Both are caches of virtual page numbers with a blocksize of one; a page number missing from both
+ * has to be walked in the page table, which may be shared by several cores.
+ */
+class tlb
+{
+
+public:
+    cache l1, l2;       // the L1 and L2 TLB, indexed by virtual page number.
+    bool hasL2;         // if there is an L2 TLB.
+    page_table *table;  // the page table walked on a miss.
+    long long walks;    // page walks, misses in every TLB.
+    long long walkHits[3]; // walk references served by cache 1, cache 2, and memory.
+
+    /**
+     * @brief The tlb constructor sets the geometry of both TLBs, an associativity of zero is fully associative.
+     * @param entries L1 TLB entries.
+     * @param assoc L1 TLB associativity.
+     * @param l2Entries L2 TLB entries, zero for no L2 TLB.
+     * @param l2Assoc L2 TLB associativity.
+     * @param pages the page table.
+     */
+    tlb(int entries, int assoc, int l2Entries, int l2Assoc, page_table *pages)
+        : l1(lines(entries, assoc), 1, ways(entries, assoc)),
+          l2(lines(l2Entries, l2Assoc), 1, ways(l2Entries, l2Assoc))
+    {
+        hasL2 = l2Entries > 0;
+        table = pages;
+        walks = 0;
+        walkHits[0] = walkHits[1] = walkHits[2] = 0;
+        l1.observed = l2.observed = false; // TLB lookups are not cache events.
+    }
+
+    /**
+     * @brief The ways function returns the associativity of a TLB, all of its entries when fully associative.
+     */
+    static int ways(int entries, int assoc)
+    {
+        return (assoc == 0) ? max(entries, 1) : assoc;
+    }
+
+    /**
+     * @brief The lines function returns the number of sets of a TLB.
+     */
+    static int lines(int entries, int assoc)
+    {
+        return max(entries / ways(entries, assoc), 1);
+    }
+
+    /**
+     * @brief The lookup function looks a virtual page up in the L1 TLB, then the L2 TLB. Both are filled on a
+     * miss, as the walk that follows brings the translation.
+     * @param vpn the virtual page number.
+     * @return true if a TLB had the translation, false if the page table has to be walked.
+     */
+    bool lookup(long long vpn)
+    {
+        l1.config_Cache(vpn);
+        l1.cacheType();
+        if (l1.status == "HIT")
+            return true;
+
+        if (hasL2)
+        {
+            l2.config_Cache(vpn);
+            l2.cacheType();
+            if (l2.status == "HIT")
+                return true;
+        }
+
+        walks++;
+        return false;
+    }
+};
@@ -0,0 +1,78 @@
+# We're testing the simulator benchmarks. bench runs every program in
+# tests-cache, this loop included, and counts the instructions of a run.
+# Comparing with an earlier run that was far faster reports a regression
+# and exits with status 1.
+
+    movi $1, 20             # iterations
+loop:
+    lw $2, 40($1)
+    sw $2, 48($1)
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010010100;		// movi $1,20
+# ram[1] = 16'b1000010100101000;		// loop: lw $2,40($1)
+# ram[2] = 16'b1010010100110000;		// sw $2,48($1)
+# ram[3] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[4] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[5] = 16'b0100000000000001;		// j loop
+# ram[6] = 16'b0100000000000110;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# bench-loop.bin --cache 8,2,2
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	L1 MISS  pc:    1	addr:   60	line:   0
+# 	L1 SW    pc:    2	addr:   68	line:   0
+# 	L1 MISS  pc:    1	addr:   59	line:   1
+# 	L1 SW    pc:    2	addr:   67	line:   1
+# 	L1 HIT   pc:    1	addr:   58	line:   1
+# 	L1 SW    pc:    2	addr:   66	line:   1
+# 	L1 MISS  pc:    1	addr:   57	line:   0
+# 	L1 SW    pc:    2	addr:   65	line:   0
+# 	L1 HIT   pc:    1	addr:   56	line:   0
+# 	L1 SW    pc:    2	addr:   64	line:   0
+# 	L1 MISS  pc:    1	addr:   55	line:   1
+# 	L1 SW    pc:    2	addr:   63	line:   1
+# 	L1 HIT   pc:    1	addr:   54	line:   1
+# 	L1 SW    pc:    2	addr:   62	line:   1
+# 	L1 MISS  pc:    1	addr:   53	line:   0
+# 	L1 SW    pc:    2	addr:   61	line:   0
+# 	L1 HIT   pc:    1	addr:   52	line:   0
+# 	L1 SW    pc:    2	addr:   60	line:   0
+# 	L1 MISS  pc:    1	addr:   51	line:   1
+# 	L1 SW    pc:    2	addr:   59	line:   1
+# 	L1 HIT   pc:    1	addr:   50	line:   1
+# 	L1 SW    pc:    2	addr:   58	line:   1
+# 	L1 MISS  pc:    1	addr:   49	line:   0
+# 	L1 SW    pc:    2	addr:   57	line:   0
+# 	L1 HIT   pc:    1	addr:   48	line:   0
+# 	L1 SW    pc:    2	addr:   56	line:   0
+# 	L1 MISS  pc:    1	addr:   47	line:   1
+# 	L1 SW    pc:    2	addr:   55	line:   1
+# 	L1 HIT   pc:    1	addr:   46	line:   1
+# 	L1 SW    pc:    2	addr:   54	line:   1
+# 	L1 MISS  pc:    1	addr:   45	line:   0
+# 	L1 SW    pc:    2	addr:   53	line:   0
+# 	L1 HIT   pc:    1	addr:   44	line:   0
+# 	L1 SW    pc:    2	addr:   52	line:   0
+# 	L1 MISS  pc:    1	addr:   43	line:   1
+# 	L1 SW    pc:    2	addr:   51	line:   1
+# 	L1 HIT   pc:    1	addr:   42	line:   1
+# 	L1 SW    pc:    2	addr:   50	line:   1
+# 	L1 MISS  pc:    1	addr:   41	line:   0
+# 	L1 SW    pc:    2	addr:   49	line:   0
+# 
+# bench --programs . --accesses 64 --min-time 0.000001 --out $TMP/bench.json > /dev/null; grep -o '"name": "sim/bench-loop/[^,]*, "ops": [0-9]*' $TMP/bench.json
+# 	"name": "sim/bench-loop/l1", "ops": 101
+# 	"name": "sim/bench-loop/l1l2", "ops": 101
+# 
+# bench --programs . --accesses 64 --min-time 0.000001 --compare <(echo '"name": "sim/bench-loop/l1", "ops": 1, "ns_per_op": 0.001') | grep 'regressions over'; echo "exit ${PIPESTATUS[0]}"
+# 	1 regressions over 10.00%
+# 	exit 1
+# 
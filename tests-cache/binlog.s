@@ -0,0 +1,64 @@
+# We're testing binary logs. The run is written as a binary log in
+# blocks of four records, decoded back to exactly the text the run
+# prints, and read from the middle by seeking to the block of a record.
+
+    movi $1, 5              # iterations
+loop:
+    lw $2, 30($1)
+    sw $2, 50($1)
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000101;		// movi $1,5
+# ram[1] = 16'b1000010100011110;		// loop: lw $2,30($1)
+# ram[2] = 16'b1010010100110010;		// sw $2,50($1)
+# ram[3] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[4] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[5] = 16'b0100000000000001;		// j loop
+# ram[6] = 16'b0100000000000110;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# simcache --cache 8,2,2,32,2,4 --binlog $TMP/run.bl --binlog-block 4 binlog.bin; simcache --decode $TMP/run.bl
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	L1 MISS  pc:    1	addr:   35	line:   1
+# 	L2 MISS  pc:    1	addr:   35	line:   0
+# 	L1 SW    pc:    2	addr:   55	line:   1
+# 	L2 SW    pc:    2	addr:   55	line:   1
+# 	L1 HIT   pc:    1	addr:   34	line:   1
+# 	L1 SW    pc:    2	addr:   54	line:   1
+# 	L2 SW    pc:    2	addr:   54	line:   1
+# 	L1 MISS  pc:    1	addr:   33	line:   0
+# 	L2 HIT   pc:    1	addr:   33	line:   0
+# 	L1 SW    pc:    2	addr:   53	line:   0
+# 	L2 SW    pc:    2	addr:   53	line:   1
+# 	L1 HIT   pc:    1	addr:   32	line:   0
+# 	L1 SW    pc:    2	addr:   52	line:   0
+# 	L2 SW    pc:    2	addr:   52	line:   1
+# 	L1 MISS  pc:    1	addr:   31	line:   1
+# 	L2 MISS  pc:    1	addr:   31	line:   3
+# 	L1 SW    pc:    2	addr:   51	line:   1
+# 	L2 SW    pc:    2	addr:   51	line:   0
+# 
+# simcache --cache 8,2,2,32,2,4 binlog.bin > $TMP/run.txt; simcache --decode $TMP/run.bl | cmp - $TMP/run.txt && echo same
+# 	same
+# 
+# --decode $TMP/run.bl --from 9 --count 5
+# 	L1 MISS  pc:    1	addr:   33	line:   0
+# 	L2 HIT   pc:    1	addr:   33	line:   0
+# 	L1 SW    pc:    2	addr:   53	line:   0
+# 	L2 SW    pc:    2	addr:   53	line:   1
+# 	L1 HIT   pc:    1	addr:   32	line:   0
+# 
+# simcache --decode $TMP/run.bl --from x 2> /dev/null; echo "exit $?"
+# 	exit 1
+# 
+# --decode binlog.s
+# 	Can't read binary log binlog.s
+# 
@@ -0,0 +1,66 @@
+# We're testing coherence between cores. Every core runs this program
+# with its core number in $7. Both cores read the shared cell, then
+# write it. Each write invalidates the copy of the other core, so core 0
+# misses when it reads the cell again after core 1 wrote it. The private
+# cells are never shared.
+
+    lw $1, shared($0)       # both cores read the shared cell
+    add $2, $1, $7
+    sw $2, shared($0)       # every write invalidates the other copy
+    lw $3, shared($0)
+    lw $4, private($7)      # each core reads its own cell
+    halt
+shared:
+    .fill 10
+private:
+    .fill 1
+    .fill 2
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b1000000010000110;		// lw $1,shared($0)
+# ram[1] = 16'b0000011110100000;		// add $2,$1,$7
+# ram[2] = 16'b1010000100000110;		// sw $2,shared($0)
+# ram[3] = 16'b1000000110000110;		// lw $3,shared($0)
+# ram[4] = 16'b1001111000000111;		// lw $4,private($7)
+# ram[5] = 16'b0100000000000101;		// halt 
+# ram[6] = 16'b0000000000001010;		// shared: .fill 10
+# ram[7] = 16'b0000000000000001;		// private: .fill 1
+# ram[8] = 16'b0000000000000010;		// .fill 2
+#--
+#--
+#--EXECUTION OUTPUT
+# coherence.bin --cores 2 --core-reg 7 --cache 8,2,1,32,4,2
+# 	Cache L1 has size 8, associativity 2, blocksize 1, lines 4
+# 	Cache L2 has size 32, associativity 4, blocksize 2, lines 4
+# 	C0:L1 MISS pc:    0	addr:    6	line:   2
+# 	C0:L2 MISS pc:    0	addr:    6	line:   3
+# 	C1:L1 MISS pc:    0	addr:    6	line:   2
+# 	C1:L2 HIT pc:    0	addr:    6	line:   3
+# 	C0:L1 SW pc:    2	addr:    6	line:   2
+# 	C0:L2 SW pc:    2	addr:    6	line:   3
+# 	C1:L1 SW pc:    2	addr:    6	line:   2
+# 	C1:L2 SW pc:    2	addr:    6	line:   3
+# 	C0:L1 MISS pc:    3	addr:    6	line:   2
+# 	C0:L2 HIT pc:    3	addr:    6	line:   3
+# 	C1:L1 HIT pc:    3	addr:    6	line:   2
+# 	C0:L1 MISS pc:    4	addr:    7	line:   3
+# 	C0:L2 HIT pc:    4	addr:    7	line:   3
+# 	C1:L1 MISS pc:    4	addr:    8	line:   0
+# 	C1:L2 MISS pc:    4	addr:    8	line:   0
+# 	C0:L1 accesses 4, hits 1, misses 3, hit rate 25.00%
+# 	C1:L1 accesses 4, hits 1, misses 3, hit rate 25.00%
+# 	Shared L2 accesses 7, hits 5, misses 2, hit rate 71.43%
+# 	Coherence bus reads 5, read-exclusives 1, upgrades 1, invalidations 2 (false sharing 0), interventions 2
+# 
+# coherence.bin --cores 2 --core-reg 7 --core-pc 0,4 --cache 8,2,1
+# 	Cache L1 has size 8, associativity 2, blocksize 1, lines 4
+# 	C0:L1 MISS pc:    0	addr:    6	line:   2
+# 	C1:L1 MISS pc:    4	addr:    8	line:   0
+# 	C0:L1 SW pc:    2	addr:    6	line:   2
+# 	C0:L1 HIT pc:    3	addr:    6	line:   2
+# 	C0:L1 MISS pc:    4	addr:    7	line:   3
+# 	C0:L1 accesses 4, hits 2, misses 2, hit rate 50.00%
+# 	C1:L1 accesses 1, hits 0, misses 1, hit rate 0.00%
+# 	Coherence bus reads 3, read-exclusives 0, upgrades 0, invalidations 0 (false sharing 0), interventions 0
+# 
@@ -0,0 +1,63 @@
+# We're testing the DRAM model, with rows of 16 cells over two banks.
+# The loads don't depend on each other: 32 and 34 share a row of bank 0,
+# 48 opens a row of bank 1, 64 is another row of bank 0 and conflicts
+# with the open one, and 36 goes back to the first row. With the open
+# page policy the second access to a row is a row hit. With --mshr the
+# requests queue at the banks, and the controller serves 36 ahead of 64,
+# turning the conflict into a row hit.
+
+    lw $1, 32($0)
+    lw $2, 34($0)           # same row
+    lw $3, 48($0)           # bank 1
+    lw $4, 64($0)           # bank 0, another row
+    lw $5, 36($0)           # back to the first row
+    add $6, $1, $5
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b1000000010100000;		// lw $1,32($0)
+# ram[1] = 16'b1000000100100010;		// lw $2,34($0)
+# ram[2] = 16'b1000000110110000;		// lw $3,48($0)
+# ram[3] = 16'b1000001001000000;		// lw $4,64($0)
+# ram[4] = 16'b1000001010100100;		// lw $5,36($0)
+# ram[5] = 16'b0000011011100000;		// add $6,$1,$5
+# ram[6] = 16'b0100000000000110;		// halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# dram.bin --cache 4,1,2 --dram 1,2,16
+# 	Cache L1 has size 4, associativity 1, blocksize 2, lines 2
+# 	L1 MISS  pc:    0	addr:   32	line:   0
+# 	L1 MISS  pc:    1	addr:   34	line:   1
+# 	L1 MISS  pc:    2	addr:   48	line:   0
+# 	L1 MISS  pc:    3	addr:65472	line:   0
+# 	L1 MISS  pc:    4	addr:   36	line:   0
+# 	Timing cycles 252, instructions 7, CPI 36.00, load-use stall cycles 0, miss stall cycles 245
+# 	DRAM open-page requests 5, row hits 1, row misses 2, row conflicts 2, row hit rate 20.00%, reordered 0, average latency 48.00 cycles
+# 
+# dram.bin --cache 4,1,2 --dram 1,2,16 --close-page
+# 	Cache L1 has size 4, associativity 1, blocksize 2, lines 2
+# 	L1 MISS  pc:    0	addr:   32	line:   0
+# 	L1 MISS  pc:    1	addr:   34	line:   1
+# 	L1 MISS  pc:    2	addr:   48	line:   0
+# 	L1 MISS  pc:    3	addr:65472	line:   0
+# 	L1 MISS  pc:    4	addr:   36	line:   0
+# 	Timing cycles 268, instructions 7, CPI 38.29, load-use stall cycles 0, miss stall cycles 261
+# 	DRAM close-page requests 5, row hits 0, row misses 5, row conflicts 0, row hit rate 0.00%, reordered 0, average latency 51.20 cycles
+# 
+# dram.bin --cache 4,1,2 --dram 1,2,16,10,20,30 --mshr 8
+# 	Cache L1 has size 4, associativity 1, blocksize 2, lines 2
+# 	L1 MISS  pc:    0	addr:   32	line:   0
+# 	L1 MISS  pc:    1	addr:   34	line:   1
+# 	L1 MISS  pc:    2	addr:   48	line:   0
+# 	L1 MISS  pc:    3	addr:65472	line:   0
+# 	L1 MISS  pc:    4	addr:   36	line:   0
+# 	Timing cycles 93, instructions 7, CPI 13.29, load-use stall cycles 86, miss stall cycles 0
+# 	MSHR L1 registers 8, primary misses 5, merges 0, full stall cycles 0, average occupancy 2.55, peak occupancy 5
+# 	DRAM open-page requests 5, row hits 2, row misses 2, row conflicts 1, row hit rate 40.00%, reordered 1, average latency 46.40 cycles
+# 
+# dram.bin --cache 4,1,2 --dram 1,0,16
+# 	Cache L1 has size 4, associativity 1, blocksize 2, lines 2
+# 	Invalid DRAM config
+# 
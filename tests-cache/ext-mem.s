@@ -0,0 +1,63 @@
+# We're testing extended memory. The segment register, loaded with setseg,
+# supplies the upper 16 bits of every data address, so the same offsets
+# reach different cells in different segments. Cache lines and tags are
+# computed on the full address.
+
+    movi $1, 2
+    setseg $1           # segment 2 starts at address 131072
+    movi $2, 7
+    sw $2, 60($0)       # stores to 131132
+    lw $3, 60($0)       # this should be a hit
+    movi $1, 0
+    setseg $1           # back to segment 0
+    lw $4, 60($0)       # address 60, same line but another tag
+    sw $4, 60($0)
+    addi $5, $0, -1
+    setseg $5           # the last segment
+    lw $6, 127($5)      # the offset wraps around to 126 in segment 65535
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000010;		// movi $1,2
+# ram[1] = 16'b0000010000001001;		// setseg $1
+# ram[2] = 16'b0010000100000111;		// movi $2,7
+# ram[3] = 16'b1010000100111100;		// sw $2,60($0)
+# ram[4] = 16'b1000000110111100;		// lw $3,60($0)
+# ram[5] = 16'b0010000010000000;		// movi $1,0
+# ram[6] = 16'b0000010000001001;		// setseg $1
+# ram[7] = 16'b1000001000111100;		// lw $4,60($0)
+# ram[8] = 16'b1010001000111100;		// sw $4,60($0)
+# ram[9] = 16'b0010001011111111;		// addi $5,$0,-1
+# ram[10] = 16'b0001010000001001;		// setseg $5
+# ram[11] = 16'b1001011101111111;		// lw $6,127($5)
+# ram[12] = 16'b0100000000001100;		// halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# ext-mem.bin --cache 4,1,1; echo "exit $?"
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	Invalid E20 Instuctions.
+# 	exit 1
+# 
+# ext-mem.bin --ext-mem --cache 4,1,1
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	L1 SW    pc:    3	addr:131132	line:   0
+# 	L1 HIT   pc:    4	addr:131132	line:   0
+# 	L1 MISS  pc:    7	addr:   60	line:   0
+# 	L1 SW    pc:    8	addr:   60	line:   0
+# 	L1 MISS  pc:   11	addr:4294967294	line:   2
+# 
+# ext-mem.bin --ext-mem --cache 16,2,2,64,4,4
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	Cache L2 has size 64, associativity 4, blocksize 4, lines 4
+# 	L1 SW    pc:    3	addr:131132	line:   2
+# 	L2 SW    pc:    3	addr:131132	line:   3
+# 	L1 HIT   pc:    4	addr:131132	line:   2
+# 	L1 MISS  pc:    7	addr:   60	line:   2
+# 	L2 MISS  pc:    7	addr:   60	line:   3
+# 	L1 SW    pc:    8	addr:   60	line:   2
+# 	L2 SW    pc:    8	addr:   60	line:   3
+# 	L1 MISS  pc:   11	addr:4294967294	line:   3
+# 	L2 MISS  pc:   11	addr:4294967294	line:   3
+# 
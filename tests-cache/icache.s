@@ -0,0 +1,149 @@
+# We're testing instruction caches. The loop runs three times, so its
+# instructions miss in the instruction cache the first time and hit
+# after that, while the data loads go through the data cache. With
+# --unified both share cache 1 and compete for its lines.
+
+    movi $1, 3          # loop counter
+    movi $2, 0          # sum
+loop:
+    lw $3, data($1)
+    add $2, $2, $3
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+data:
+    .fill 0
+    .fill 5
+    .fill 6
+    .fill 7
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000011;		// movi $1,3
+# ram[1] = 16'b0010000100000000;		// movi $2,0
+# ram[2] = 16'b1000010110001000;		// loop: lw $3,data($1)
+# ram[3] = 16'b0000100110100000;		// add $2,$2,$3
+# ram[4] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[5] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[6] = 16'b0100000000000010;		// j loop
+# ram[7] = 16'b0100000000000111;		// done: halt 
+# ram[8] = 16'b0000000000000000;		// data: .fill 0
+# ram[9] = 16'b0000000000000101;		// .fill 5
+# ram[10] = 16'b0000000000000110;		// .fill 6
+# ram[11] = 16'b0000000000000111;		// .fill 7
+#--
+#--
+#--EXECUTION OUTPUT
+# icache.bin --cache 8,2,1,32,2,4 --icache 8,1,2 --log-fetch
+# 	Cache L1 has size 8, associativity 2, blocksize 1, lines 4
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	Cache L1I has size 8, associativity 1, blocksize 2, lines 4
+# 	L1I IMISS pc:    0	addr:    0	line:   0
+# 	L2 IMISS pc:    0	addr:    0	line:   0
+# 	L1I IHIT pc:    1	addr:    1	line:   0
+# 	L1I IMISS pc:    2	addr:    2	line:   1
+# 	L2 IHIT  pc:    2	addr:    2	line:   0
+# 	L1 MISS  pc:    2	addr:   11	line:   3
+# 	L2 MISS  pc:    2	addr:   11	line:   2
+# 	L1I IHIT pc:    3	addr:    3	line:   1
+# 	L1I IMISS pc:    4	addr:    4	line:   2
+# 	L2 IMISS pc:    4	addr:    4	line:   1
+# 	L1I IHIT pc:    5	addr:    5	line:   2
+# 	L1I IMISS pc:    6	addr:    6	line:   3
+# 	L2 IHIT  pc:    6	addr:    6	line:   1
+# 	L1I IHIT pc:    2	addr:    2	line:   1
+# 	L1 MISS  pc:    2	addr:   10	line:   2
+# 	L2 HIT   pc:    2	addr:   10	line:   2
+# 	L1I IHIT pc:    3	addr:    3	line:   1
+# 	L1I IHIT pc:    4	addr:    4	line:   2
+# 	L1I IHIT pc:    5	addr:    5	line:   2
+# 	L1I IHIT pc:    6	addr:    6	line:   3
+# 	L1I IHIT pc:    2	addr:    2	line:   1
+# 	L1 MISS  pc:    2	addr:    9	line:   1
+# 	L2 HIT   pc:    2	addr:    9	line:   2
+# 	L1I IHIT pc:    3	addr:    3	line:   1
+# 	L1I IHIT pc:    4	addr:    4	line:   2
+# 	L1I IHIT pc:    5	addr:    5	line:   2
+# 	L1I IHIT pc:    7	addr:    7	line:   3
+# 	I-fetch L1 accesses 17, hits 13, misses 4, hit rate 76.47%
+# 	Data L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	I-fetch L2 accesses 4, hits 2, misses 2, hit rate 50.00%
+# 	Data L2 accesses 3, hits 2, misses 1, hit rate 66.67%
+# 
+# icache.bin --cores 2 --cache 8,2,1,32,2,4 --icache 8,1,2
+# 	Cache L1 has size 8, associativity 2, blocksize 1, lines 4
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	Cache L1I has size 8, associativity 1, blocksize 2, lines 4
+# 	C0:L1 MISS pc:    2	addr:   11	line:   3
+# 	C0:L2 MISS pc:    2	addr:   11	line:   2
+# 	C1:L1 MISS pc:    2	addr:   11	line:   3
+# 	C1:L2 HIT pc:    2	addr:   11	line:   2
+# 	C0:L1 MISS pc:    2	addr:   10	line:   2
+# 	C0:L2 HIT pc:    2	addr:   10	line:   2
+# 	C1:L1 MISS pc:    2	addr:   10	line:   2
+# 	C1:L2 HIT pc:    2	addr:   10	line:   2
+# 	C0:L1 MISS pc:    2	addr:    9	line:   1
+# 	C0:L2 HIT pc:    2	addr:    9	line:   2
+# 	C1:L1 MISS pc:    2	addr:    9	line:   1
+# 	C1:L2 HIT pc:    2	addr:    9	line:   2
+# 	C0:I-fetch L1 accesses 17, hits 13, misses 4, hit rate 76.47%
+# 	C0:Data L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	C1:I-fetch L1 accesses 17, hits 13, misses 4, hit rate 76.47%
+# 	C1:Data L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Shared L2 accesses 14, hits 11, misses 3, hit rate 78.57%
+# 	I-fetch L2 accesses 8, hits 6, misses 2, hit rate 75.00%
+# 	Data L2 accesses 6, hits 5, misses 1, hit rate 83.33%
+# 	Coherence bus reads 6, read-exclusives 0, upgrades 0, invalidations 0 (false sharing 0), interventions 0
+# 
+# icache.bin --cache 8,2,1 --icache 16,2,4
+# 	Cache L1 has size 8, associativity 2, blocksize 1, lines 4
+# 	Cache L1I has size 16, associativity 2, blocksize 4, lines 2
+# 	L1 MISS  pc:    2	addr:   11	line:   3
+# 	L1 MISS  pc:    2	addr:   10	line:   2
+# 	L1 MISS  pc:    2	addr:    9	line:   1
+# 	I-fetch L1 accesses 17, hits 15, misses 2, hit rate 88.24%
+# 	Data L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 
+# icache.bin --cache 8,1,2,32,2,4 --unified --log-fetch
+# 	Cache L1 has size 8, associativity 1, blocksize 2, lines 4
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	L1 IMISS pc:    0	addr:    0	line:   0
+# 	L2 IMISS pc:    0	addr:    0	line:   0
+# 	L1 IHIT  pc:    1	addr:    1	line:   0
+# 	L1 IMISS pc:    2	addr:    2	line:   1
+# 	L2 IHIT  pc:    2	addr:    2	line:   0
+# 	L1 MISS  pc:    2	addr:   11	line:   1
+# 	L2 MISS  pc:    2	addr:   11	line:   2
+# 	L1 IMISS pc:    3	addr:    3	line:   1
+# 	L2 IHIT  pc:    3	addr:    3	line:   0
+# 	L1 IMISS pc:    4	addr:    4	line:   2
+# 	L2 IMISS pc:    4	addr:    4	line:   1
+# 	L1 IHIT  pc:    5	addr:    5	line:   2
+# 	L1 IMISS pc:    6	addr:    6	line:   3
+# 	L2 IHIT  pc:    6	addr:    6	line:   1
+# 	L1 IHIT  pc:    2	addr:    2	line:   1
+# 	L1 MISS  pc:    2	addr:   10	line:   1
+# 	L2 HIT   pc:    2	addr:   10	line:   2
+# 	L1 IMISS pc:    3	addr:    3	line:   1
+# 	L2 IHIT  pc:    3	addr:    3	line:   0
+# 	L1 IHIT  pc:    4	addr:    4	line:   2
+# 	L1 IHIT  pc:    5	addr:    5	line:   2
+# 	L1 IHIT  pc:    6	addr:    6	line:   3
+# 	L1 IHIT  pc:    2	addr:    2	line:   1
+# 	L1 MISS  pc:    2	addr:    9	line:   0
+# 	L2 HIT   pc:    2	addr:    9	line:   2
+# 	L1 IHIT  pc:    3	addr:    3	line:   1
+# 	L1 IHIT  pc:    4	addr:    4	line:   2
+# 	L1 IHIT  pc:    5	addr:    5	line:   2
+# 	L1 IHIT  pc:    7	addr:    7	line:   3
+# 	I-fetch L1 accesses 17, hits 11, misses 6, hit rate 64.71%
+# 	Data L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	I-fetch L2 accesses 6, hits 4, misses 2, hit rate 66.67%
+# 	Data L2 accesses 3, hits 2, misses 1, hit rate 66.67%
+# 
+# icache.bin --cache 8,2,1 --icache 8,0,2
+# 	Cache L1 has size 8, associativity 2, blocksize 1, lines 4
+# 	Invalid instruction cache config
+# 
@@ -0,0 +1,136 @@
+# We're testing way partitioning of the shared cache 2, with one set of
+# four ways split 2,2 between two cores. Core 0 fills three blocks, so
+# its third fill replaces its own least recently used block. Started at
+# hits, core 1 then loads the blocks of core 0, which hit in cache 2
+# and stay with core 0. Started at idle it does nothing, and the blocks
+# each core holds come out the same: a hit never changes occupancy.
+# Started at fills with a 3,1 split, core 1 keeps replacing its single
+# way. The quotas must add up to the associativity. The last runs turn
+# on set dueling in cache 2, which needs it to be associative.
+
+    lw $1, 40($0)           # core 0
+    lw $1, 41($0)
+    lw $1, 42($0)           # replaces 40, its own block
+    halt
+hits:
+    nop                     # core 1, after core 0 filled
+    nop
+    nop
+    lw $2, 41($0)           # hits the blocks of core 0
+    lw $2, 42($0)
+    lw $2, 41($0)
+    halt
+idle:
+    halt
+fills:
+    lw $2, 50($0)
+    lw $2, 51($0)
+    lw $2, 52($0)
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b1000000010101000;		// lw $1,40($0)
+# ram[1] = 16'b1000000010101001;		// lw $1,41($0)
+# ram[2] = 16'b1000000010101010;		// lw $1,42($0)
+# ram[3] = 16'b0100000000000011;		// halt 
+# ram[4] = 16'b0000000000000000;		// hits: nop 
+# ram[5] = 16'b0000000000000000;		// nop 
+# ram[6] = 16'b0000000000000000;		// nop 
+# ram[7] = 16'b1000000100101001;		// lw $2,41($0)
+# ram[8] = 16'b1000000100101010;		// lw $2,42($0)
+# ram[9] = 16'b1000000100101001;		// lw $2,41($0)
+# ram[10] = 16'b0100000000001010;		// halt 
+# ram[11] = 16'b0100000000001011;		// idle: halt 
+# ram[12] = 16'b1000000100110010;		// fills: lw $2,50($0)
+# ram[13] = 16'b1000000100110011;		// lw $2,51($0)
+# ram[14] = 16'b1000000100110100;		// lw $2,52($0)
+# ram[15] = 16'b0100000000001111;		// halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# partition.bin --cores 2 --core-pc 0,4 --cache 1,1,1,4,4,1 --partition 2,2
+# 	Cache L1 has size 1, associativity 1, blocksize 1, lines 1
+# 	Cache L2 has size 4, associativity 4, blocksize 1, lines 1
+# 	C0:L1 MISS pc:    0	addr:   40	line:   0
+# 	C0:L2 MISS pc:    0	addr:   40	line:   0
+# 	C0:L1 MISS pc:    1	addr:   41	line:   0
+# 	C0:L2 MISS pc:    1	addr:   41	line:   0
+# 	C0:L1 MISS pc:    2	addr:   42	line:   0
+# 	C0:L2 MISS pc:    2	addr:   42	line:   0
+# 	C1:L1 MISS pc:    7	addr:   41	line:   0
+# 	C1:L2 HIT pc:    7	addr:   41	line:   0
+# 	C1:L1 MISS pc:    8	addr:   42	line:   0
+# 	C1:L2 HIT pc:    8	addr:   42	line:   0
+# 	C1:L1 MISS pc:    9	addr:   41	line:   0
+# 	C1:L2 HIT pc:    9	addr:   41	line:   0
+# 	C0:L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	C1:L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Shared L2 accesses 6, hits 3, misses 3, hit rate 50.00%
+# 	Coherence bus reads 6, read-exclusives 0, upgrades 0, invalidations 0 (false sharing 0), interventions 0
+# 	Partition Shared L2 C0 ways 2, blocks 2, accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Partition Shared L2 C1 ways 2, blocks 0, accesses 3, hits 3, misses 0, hit rate 100.00%
+# 
+# partition.bin --cores 2 --core-pc 0,11 --cache 1,1,1,4,4,1 --partition 2,2
+# 	Cache L1 has size 1, associativity 1, blocksize 1, lines 1
+# 	Cache L2 has size 4, associativity 4, blocksize 1, lines 1
+# 	C0:L1 MISS pc:    0	addr:   40	line:   0
+# 	C0:L2 MISS pc:    0	addr:   40	line:   0
+# 	C0:L1 MISS pc:    1	addr:   41	line:   0
+# 	C0:L2 MISS pc:    1	addr:   41	line:   0
+# 	C0:L1 MISS pc:    2	addr:   42	line:   0
+# 	C0:L2 MISS pc:    2	addr:   42	line:   0
+# 	C0:L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	C1:L1 accesses 0, hits 0, misses 0, hit rate 0.00%
+# 	Shared L2 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Coherence bus reads 3, read-exclusives 0, upgrades 0, invalidations 0 (false sharing 0), interventions 0
+# 	Partition Shared L2 C0 ways 2, blocks 2, accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Partition Shared L2 C1 ways 2, blocks 0, accesses 0, hits 0, misses 0, hit rate 0.00%
+# 
+# simcache --cores 2 --core-pc 0,4 --cache 1,1,1,4,4,1 --partition 2,2 partition.bin > $TMP/hits; simcache --cores 2 --core-pc 0,11 --cache 1,1,1,4,4,1 --partition 2,2 partition.bin > $TMP/idle; diff <(grep -o 'C[0-9] ways [0-9]*, blocks [0-9]*' $TMP/hits) <(grep -o 'C[0-9] ways [0-9]*, blocks [0-9]*' $TMP/idle) && echo "same blocks"
+# 	same blocks
+# 
+# partition.bin --cores 2 --core-pc 0,12 --cache 1,1,1,4,4,1 --partition 3,1
+# 	Cache L1 has size 1, associativity 1, blocksize 1, lines 1
+# 	Cache L2 has size 4, associativity 4, blocksize 1, lines 1
+# 	C0:L1 MISS pc:    0	addr:   40	line:   0
+# 	C0:L2 MISS pc:    0	addr:   40	line:   0
+# 	C1:L1 MISS pc:   12	addr:   50	line:   0
+# 	C1:L2 MISS pc:   12	addr:   50	line:   0
+# 	C0:L1 MISS pc:    1	addr:   41	line:   0
+# 	C0:L2 MISS pc:    1	addr:   41	line:   0
+# 	C1:L1 MISS pc:   13	addr:   51	line:   0
+# 	C1:L2 MISS pc:   13	addr:   51	line:   0
+# 	C0:L1 MISS pc:    2	addr:   42	line:   0
+# 	C0:L2 MISS pc:    2	addr:   42	line:   0
+# 	C1:L1 MISS pc:   14	addr:   52	line:   0
+# 	C1:L2 MISS pc:   14	addr:   52	line:   0
+# 	C0:L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	C1:L1 accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Shared L2 accesses 6, hits 0, misses 6, hit rate 0.00%
+# 	Coherence bus reads 6, read-exclusives 0, upgrades 0, invalidations 0 (false sharing 0), interventions 0
+# 	Partition Shared L2 C0 ways 3, blocks 3, accesses 3, hits 0, misses 3, hit rate 0.00%
+# 	Partition Shared L2 C1 ways 1, blocks 1, accesses 3, hits 0, misses 3, hit rate 0.00%
+# 
+# partition.bin --cores 2 --cache 1,1,1,4,4,1 --partition 3,2
+# 	Cache L1 has size 1, associativity 1, blocksize 1, lines 1
+# 	Cache L2 has size 4, associativity 4, blocksize 1, lines 1
+# 	Invalid partition config
+# 
+# partition.bin --cache 1,1,1,8,2,1 --dip
+# 	Cache L1 has size 1, associativity 1, blocksize 1, lines 1
+# 	Cache L2 has size 8, associativity 2, blocksize 1, lines 4
+# 	L1 MISS  pc:    0	addr:   40	line:   0
+# 	L2 MISS  pc:    0	addr:   40	line:   0
+# 	L1 MISS  pc:    1	addr:   41	line:   0
+# 	L2 MISS  pc:    1	addr:   41	line:   1
+# 	L1 MISS  pc:    2	addr:   42	line:   0
+# 	L2 MISS  pc:    2	addr:   42	line:   2
+# 	Set dueling L2 PSEL 512 (min 511, max 512), accesses under LRU 1 (33.33%), under BIP 2 (66.67%), leader misses LRU 1, BIP 0
+# 	Set dueling L2 PSEL every 1 accesses: 512 512 512
+# 
+# partition.bin --cache 1,1,1,4,1,1 --dip
+# 	Cache L1 has size 1, associativity 1, blocksize 1, lines 1
+# 	Cache L2 has size 4, associativity 1, blocksize 1, lines 4
+# 	Set dueling needs a shared associative cache with at least two sets
+# 
@@ -0,0 +1,108 @@
+# We're testing analysis plugins. The example plugin miss_pcs receives
+# every cache event and prints the instructions with the most misses:
+# the strided load misses every time, the load of the same cell hits.
+# A plugin loaded twice gets every event twice. The events plugin prints
+# every event: empty ways and the block of a hit are never evicted.
+
+    movi $1, 6              # iterations
+loop:
+    lw $2, 32($3)           # a new block every time
+    lw $4, 16($0)           # the same cell every time
+    addi $3, $3, 4
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000110;		// movi $1,6
+# ram[1] = 16'b1000110100100000;		// loop: lw $2,32($3)
+# ram[2] = 16'b1000001000010000;		// lw $4,16($0)
+# ram[3] = 16'b0010110110000100;		// addi $3,$3,4
+# ram[4] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[5] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[6] = 16'b0100000000000001;		// j loop
+# ram[7] = 16'b0100000000000111;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# plugin.bin --cache 16,2,2 --plugin $PLUGINS/miss_pcs.so
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   32	line:   0
+# 	L1 MISS  pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   36	line:   2
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   40	line:   0
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   44	line:   2
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   48	line:   0
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   52	line:   2
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	Misses L1 pc 1: 6
+# 	Misses L1 pc 2: 1
+# 
+# plugin.bin --cache 16,2,2,64,4,4 --plugin $PLUGINS/miss_pcs.so --plugin $PLUGINS/miss_pcs.so
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	Cache L2 has size 64, associativity 4, blocksize 4, lines 4
+# 	L1 MISS  pc:    1	addr:   32	line:   0
+# 	L2 MISS  pc:    1	addr:   32	line:   0
+# 	L1 MISS  pc:    2	addr:   16	line:   0
+# 	L2 MISS  pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   36	line:   2
+# 	L2 MISS  pc:    1	addr:   36	line:   1
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   40	line:   0
+# 	L2 MISS  pc:    1	addr:   40	line:   2
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   44	line:   2
+# 	L2 MISS  pc:    1	addr:   44	line:   3
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   48	line:   0
+# 	L2 MISS  pc:    1	addr:   48	line:   0
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	L1 MISS  pc:    1	addr:   52	line:   2
+# 	L2 MISS  pc:    1	addr:   52	line:   1
+# 	L1 HIT   pc:    2	addr:   16	line:   0
+# 	Misses L2 pc 1: 6
+# 	Misses L1 pc 1: 6
+# 	Misses L2 pc 2: 1
+# 	Misses L1 pc 2: 1
+# 	Misses L2 pc 1: 6
+# 	Misses L1 pc 1: 6
+# 	Misses L2 pc 2: 1
+# 	Misses L1 pc 2: 1
+# 
+# plugin.bin --cache 16,2,2 --plugin ./missing.so
+# 	Can't load plugin ./missing.so: ./missing.so: cannot open shared object file: No such file or directory
+# 
+# --cache 4,4,1 --plugin $PLUGINS/events.so --replay - < <(printf 'R 100\nR 200\nR 100\nR 300\nR 400\nR 500\n')
+# 	Cache L1 has size 4, associativity 4, blocksize 1, lines 1
+# 	Event L1 ACCESS pc 0 addr 100 set 0 way 0
+# 	Event L1 MISS pc 0 addr 100 set 0 way 3
+# 	Event L1 FILL pc 0 addr 100 set 0 way 3
+# 	L1 MISS  pc:    0	addr:  100	line:   0
+# 	Event L1 ACCESS pc 0 addr 200 set 0 way 0
+# 	Event L1 MISS pc 0 addr 200 set 0 way 3
+# 	Event L1 FILL pc 0 addr 200 set 0 way 3
+# 	L1 MISS  pc:    0	addr:  200	line:   0
+# 	Event L1 ACCESS pc 0 addr 100 set 0 way 0
+# 	Event L1 HIT pc 0 addr 100 set 0 way 2
+# 	L1 HIT   pc:    0	addr:  100	line:   0
+# 	Event L1 ACCESS pc 0 addr 300 set 0 way 0
+# 	Event L1 MISS pc 0 addr 300 set 0 way 3
+# 	Event L1 FILL pc 0 addr 300 set 0 way 3
+# 	L1 MISS  pc:    0	addr:  300	line:   0
+# 	Event L1 ACCESS pc 0 addr 400 set 0 way 0
+# 	Event L1 MISS pc 0 addr 400 set 0 way 3
+# 	Event L1 FILL pc 0 addr 400 set 0 way 3
+# 	L1 MISS  pc:    0	addr:  400	line:   0
+# 	Event L1 ACCESS pc 0 addr 500 set 0 way 0
+# 	Event L1 EVICT pc 0 addr 200 set 0 way 0
+# 	Event L1 MISS pc 0 addr 500 set 0 way 3
+# 	Event L1 FILL pc 0 addr 500 set 0 way 3
+# 	L1 MISS  pc:    0	addr:  500	line:   0
+# 
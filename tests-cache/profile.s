@@ -0,0 +1,101 @@
+# We're testing the profiler. The loop body is one basic block, entered
+# from the code before it and from the jump back. With two cores, each
+# core falls through on its own, so the blocks are the same as with one
+# core and every count doubles.
+
+    movi $1, 3              # iterations
+loop:
+    lw $2, 20($1)
+    add $3, $3, $2
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    sw $3, 30($7)
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000011;		// movi $1,3
+# ram[1] = 16'b1000010100010100;		// loop: lw $2,20($1)
+# ram[2] = 16'b0000110100110000;		// add $3,$3,$2
+# ram[3] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[4] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[5] = 16'b0100000000000001;		// j loop
+# ram[6] = 16'b1011110110011110;		// done: sw $3,30($7)
+# ram[7] = 16'b0100000000000111;		// halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# simcache --cache 8,2,2 --profile $TMP/profile.json profile.bin; cat $TMP/profile.json
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	L1 MISS  pc:    1	addr:   23	line:   1
+# 	L1 HIT   pc:    1	addr:   22	line:   1
+# 	L1 MISS  pc:    1	addr:   21	line:   0
+# 	L1 SW    pc:    6	addr:   30	line:   1
+# 	Profile instructions 17, basic blocks 4
+# 	Opcode addi 4 (23.53%)
+# 	Opcode add 3 (17.65%)
+# 	Opcode j 3 (17.65%)
+# 	Opcode lw 3 (17.65%)
+# 	Opcode jeq 3 (17.65%)
+# 	Opcode sw 1 (5.88%)
+# 	Block 1-4 executions 3, instructions 12 (70.59%), loads 3, stores 0, memory density 0.25, L1 misses 2 (66.67%), L2 misses 0 (0.00%)
+# 	Block 5-5 executions 2, instructions 2 (11.76%), loads 0, stores 0, memory density 0.00, L1 misses 0 (0.00%), L2 misses 0 (0.00%)
+# 	Block 6-7 executions 1, instructions 2 (11.76%), loads 0, stores 1, memory density 0.50, L1 misses 1 (33.33%), L2 misses 0 (0.00%)
+# 	Block 0-0 executions 1, instructions 1 (5.88%), loads 0, stores 0, memory density 0.00, L1 misses 0 (0.00%), L2 misses 0 (0.00%)
+# 	Branch jeq pc 4 taken 1, not taken 2 (33.33% taken)
+# 	{
+# 	  "instructions": 17,
+# 	  "opcodes": {"add": 3, "addi": 4, "j": 3, "lw": 3, "sw": 1, "jeq": 3},
+# 	  "pcs": [
+# 	    {"pc": 0, "op": "addi", "count": 1, "l1_misses": 0, "l2_misses": 0},
+# 	    {"pc": 1, "op": "lw", "count": 3, "l1_misses": 2, "l2_misses": 0},
+# 	    {"pc": 2, "op": "add", "count": 3, "l1_misses": 0, "l2_misses": 0},
+# 	    {"pc": 3, "op": "addi", "count": 3, "l1_misses": 0, "l2_misses": 0},
+# 	    {"pc": 4, "op": "jeq", "count": 3, "l1_misses": 0, "l2_misses": 0, "taken": 1, "not_taken": 2},
+# 	    {"pc": 5, "op": "j", "count": 2, "l1_misses": 0, "l2_misses": 0},
+# 	    {"pc": 6, "op": "sw", "count": 1, "l1_misses": 1, "l2_misses": 0},
+# 	    {"pc": 7, "op": "j", "count": 1, "l1_misses": 0, "l2_misses": 0}
+# 	  ],
+# 	  "blocks": [
+# 	    {"start": 0, "end": 0, "executions": 1, "instructions": 1, "loads": 0, "stores": 0, "l1_misses": 0, "l2_misses": 0},
+# 	    {"start": 1, "end": 4, "executions": 3, "instructions": 12, "loads": 3, "stores": 0, "l1_misses": 2, "l2_misses": 0},
+# 	    {"start": 5, "end": 5, "executions": 2, "instructions": 2, "loads": 0, "stores": 0, "l1_misses": 0, "l2_misses": 0},
+# 	    {"start": 6, "end": 7, "executions": 1, "instructions": 2, "loads": 0, "stores": 1, "l1_misses": 1, "l2_misses": 0}
+# 	  ]
+# 	}
+# 
+# profile.bin --cache 8,2,2,32,2,4 --cores 2 --core-reg 7 --profile $TMP/profile.json --profile-top 3
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	C0:L1 MISS pc:    1	addr:   23	line:   1
+# 	C0:L2 MISS pc:    1	addr:   23	line:   1
+# 	C1:L1 MISS pc:    1	addr:   23	line:   1
+# 	C1:L2 HIT pc:    1	addr:   23	line:   1
+# 	C0:L1 HIT pc:    1	addr:   22	line:   1
+# 	C1:L1 HIT pc:    1	addr:   22	line:   1
+# 	C0:L1 MISS pc:    1	addr:   21	line:   0
+# 	C0:L2 HIT pc:    1	addr:   21	line:   1
+# 	C1:L1 MISS pc:    1	addr:   21	line:   0
+# 	C1:L2 HIT pc:    1	addr:   21	line:   1
+# 	C0:L1 SW pc:    6	addr:   30	line:   1
+# 	C0:L2 SW pc:    6	addr:   30	line:   3
+# 	C1:L1 SW pc:    6	addr:   31	line:   1
+# 	C1:L2 SW pc:    6	addr:   31	line:   3
+# 	C0:L1 accesses 4, hits 1, misses 3, hit rate 25.00%
+# 	C1:L1 accesses 4, hits 1, misses 3, hit rate 25.00%
+# 	Shared L2 accesses 6, hits 4, misses 2, hit rate 66.67%
+# 	Coherence bus reads 4, read-exclusives 2, upgrades 0, invalidations 1 (false sharing 1), interventions 1
+# 	Profile instructions 34, basic blocks 4
+# 	Opcode addi 8 (23.53%)
+# 	Opcode add 6 (17.65%)
+# 	Opcode j 6 (17.65%)
+# 	Opcode lw 6 (17.65%)
+# 	Opcode jeq 6 (17.65%)
+# 	Opcode sw 2 (5.88%)
+# 	Block 1-4 executions 6, instructions 24 (70.59%), loads 6, stores 0, memory density 0.25, L1 misses 4 (66.67%), L2 misses 1 (50.00%)
+# 	Block 5-5 executions 4, instructions 4 (11.76%), loads 0, stores 0, memory density 0.00, L1 misses 0 (0.00%), L2 misses 0 (0.00%)
+# 	Block 6-7 executions 2, instructions 4 (11.76%), loads 0, stores 2, memory density 0.50, L1 misses 2 (33.33%), L2 misses 1 (50.00%)
+# 	Branch jeq pc 4 taken 2, not taken 4 (33.33% taken)
+# 
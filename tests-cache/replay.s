@@ -0,0 +1,92 @@
+# We're testing pipelines and trace replay. A filename of - reads the
+# program from standard input, and prints what the same run from a file
+# prints. With --replay, replay.trace runs through the data caches in
+# place of a program. A line that can't be parsed stops the replay with
+# an error naming it, after the log of the lines before it.
+
+    movi $1, 2              # iterations
+loop:
+    lw $2, 16($1)
+    sw $2, 32($1)
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000010;		// movi $1,2
+# ram[1] = 16'b1000010100010000;		// loop: lw $2,16($1)
+# ram[2] = 16'b1010010100100000;		// sw $2,32($1)
+# ram[3] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[4] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[5] = 16'b0100000000000001;		// j loop
+# ram[6] = 16'b0100000000000110;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# --cache 8,2,2 - < replay.bin
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	L1 MISS  pc:    1	addr:   18	line:   1
+# 	L1 SW    pc:    2	addr:   34	line:   1
+# 	L1 MISS  pc:    1	addr:   17	line:   0
+# 	L1 SW    pc:    2	addr:   33	line:   0
+# 
+# simcache --cache 8,2,2 replay.bin > $TMP/file.txt; simcache --cache 8,2,2 - < replay.bin | cmp - $TMP/file.txt && echo same
+# 	same
+# 
+# --client $SOCKET --cache 8,2,2,32,2,4 - < replay.bin
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	L1 MISS  pc:    1	addr:   18	line:   1
+# 	L2 MISS  pc:    1	addr:   18	line:   0
+# 	L1 SW    pc:    2	addr:   34	line:   1
+# 	L2 SW    pc:    2	addr:   34	line:   0
+# 	L1 MISS  pc:    1	addr:   17	line:   0
+# 	L2 HIT   pc:    1	addr:   17	line:   0
+# 	L1 SW    pc:    2	addr:   33	line:   0
+# 	L2 SW    pc:    2	addr:   33	line:   0
+# 
+# --cache 8,2,2,32,2,4 --replay replay.trace
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	Cache L2 has size 32, associativity 2, blocksize 4, lines 4
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L2 MISS  pc:    0	addr:   16	line:   0
+# 	L1 HIT   pc:    1	addr:   17	line:   0
+# 	L1 SW    pc:    2	addr:   32	line:   0
+# 	L2 SW    pc:    2	addr:   32	line:   0
+# 	L1 HIT   pc:    0	addr:   17	line:   0
+# 	L1 SW    pc:    3	addr:   32	line:   0
+# 	L2 SW    pc:    3	addr:   32	line:   0
+# 	L1 HIT   pc:    0	addr:   16	line:   0
+# 
+# --cache 8,2,2 --timing 1,10,100 --replay - < replay.trace
+# 	Cache L1 has size 8, associativity 2, blocksize 2, lines 2
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L1 HIT   pc:    1	addr:   17	line:   0
+# 	L1 SW    pc:    2	addr:   32	line:   0
+# 	L1 HIT   pc:    0	addr:   17	line:   0
+# 	L1 SW    pc:    3	addr:   32	line:   0
+# 	L1 HIT   pc:    0	addr:   16	line:   0
+# 	Timing cycles 107, instructions 6, CPI 17.83, load-use stall cycles 0, miss stall cycles 101
+# 
+# simcache --cache 4,1,1 --replay - < <(printf 'R 0x1F\nW 9 0x3\nR 5 abc\nR 6\n'); echo "exit $?"
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	L1 MISS  pc:    0	addr:   31	line:   3
+# 	L1 SW    pc:    3	addr:    9	line:   1
+# 	Can't parse trace line: R 5 abc
+# 	exit 1
+# 
+# simcache --cache 4,1,1 --replay - < <(printf 'R 09\nR 0x\n'); echo "exit $?"
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	L1 MISS  pc:    0	addr:    9	line:   1
+# 	Can't parse trace line: R 0x
+# 	exit 1
+# 
+# simcache --cache 4,1,1 --replay - < <(printf 'R 7\nRW 5\n'); echo "exit $?"
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	L1 MISS  pc:    0	addr:    7	line:   3
+# 	Can't parse trace line: RW 5
+# 	exit 1
+# 
@@ -0,0 +1,97 @@
+#!/bin/bash
+# Runs the commands recorded in the EXECUTION OUTPUT section of every test program in tests-cache and
+# compares what they print with the output recorded under them.
+#
+# usage: tests-cache/run_tests.sh [--update] [SIMCACHE [BENCH]]
+#
+# A command is the arguments of a simcache run, from the tests-cache directory. A command starting with
+# `simcache` or `bench` is run by the shell as it is, so it can chain runs with `;` and pipes. $TMP is a
+# scratch directory, $SOCKET a simulation server started for the tests, and $PLUGINS holds the example
+# plugins built from src/plugins. Standard output and errors are both recorded. --update rewrites the
+# recorded output with what the commands print now.
+
+update=false
+if [ "$1" = "--update" ]; then
+    update=true
+    shift
+fi
+sim=$(realpath "${1:-./simcache}")
+bench_bin=$(realpath "${2:-./bench}")
+cd "$(dirname "$0")" || exit 1
+
+simcache() { "$sim" "$@"; }
+bench() { "$bench_bin" "$@"; }
+
+TMP=$(mktemp -d)
+SOCKET=$TMP/e20.sock
+PLUGINS=$TMP
+trap 'kill $server 2>/dev/null; rm -rf "$TMP"' EXIT
+
+for plugin in ../src/plugins/*.cpp; do
+    g++ -O2 -std=c++17 -shared -fPIC -o "$PLUGINS/$(basename "$plugin" .cpp).so" "$plugin" || exit 1
+done
+
+"$sim" --serve "$SOCKET" --workers 2 > "$TMP/server.log" 2>&1 &
+server=$!
+for i in $(seq 50); do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+
+# Runs one recorded command, with its errors on standard output.
+run() {
+    local cmd=$1
+    case $cmd in
+        simcache\ * | bench\ *) ;;
+        *) cmd="simcache $cmd" ;;
+    esac
+    eval "$cmd" 2>&1
+}
+
+# Checks the output of the current case, or records it with --update.
+finish() {
+    [ -z "$cmd" ] && return
+    run "$cmd" > "$TMP/actual"
+    cases=$((cases + 1))
+    if $update; then
+        sed 's/^/# \t/' "$TMP/actual" >> "$TMP/updated"
+        echo "# " >> "$TMP/updated"
+    elif ! diff -u "$TMP/expected" "$TMP/actual" > "$TMP/diff"; then
+        echo "FAIL $file: $cmd"
+        cat "$TMP/diff"
+        failures=$((failures + 1))
+    fi
+    cmd=
+}
+
+cases=0
+failures=0
+for file in *.s; do
+    cmd=
+    output=false
+    : > "$TMP/updated"
+    while IFS= read -r line; do
+        if ! $output; then
+            echo "$line" >> "$TMP/updated"
+            [ "$line" = "#--EXECUTION OUTPUT" ] && output=true
+        elif [[ $line == "# "$'\t'* ]]; then
+            echo "${line:3}" >> "$TMP/expected"
+        elif [ "$line" = "# " ]; then
+            finish
+        else
+            finish
+            cmd=${line#\# }
+            : > "$TMP/expected"
+            $update && echo "$line" >> "$TMP/updated"
+        fi
+    done < "$file"
+    finish
+    $update && cp "$TMP/updated" "$file"
+done
+
+if $update; then
+    echo "Recorded $cases cases"
+else
+    echo "$((cases - failures)) of $cases cases passed"
+fi
+[ $failures = 0 ]
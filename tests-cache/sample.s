@@ -0,0 +1,324 @@
+# We're testing set sampling. Two passes load the 63 cells from 32 up,
+# which is twice the size of the cache, so every block misses on its
+# first access in both passes and half the accesses miss. Only one
+# in every four sets is simulated and logged, and the miss rate of the
+# whole cache is estimated from them.
+
+    movi $4, 2              # passes
+outer:
+    movi $1, 0
+    movi $2, 63
+loop:
+    lw $3, 32($1)
+    addi $1, $1, 1
+    jeq $1, $2, next
+    j loop
+next:
+    addi $4, $4, -1
+    jeq $4, $0, done
+    j outer
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010001000000010;		// movi $4,2
+# ram[1] = 16'b0010000010000000;		// outer: movi $1,0
+# ram[2] = 16'b0010000100111111;		// movi $2,63
+# ram[3] = 16'b1000010110100000;		// loop: lw $3,32($1)
+# ram[4] = 16'b0010010010000001;		// addi $1,$1,1
+# ram[5] = 16'b1100010100000001;		// jeq $1,$2,next
+# ram[6] = 16'b0100000000000011;		// j loop
+# ram[7] = 16'b0011001001111111;		// next: addi $4,$4,-1
+# ram[8] = 16'b1101000000000001;		// jeq $4,$0,done
+# ram[9] = 16'b0100000000000001;		// j outer
+# ram[10] = 16'b0100000000001010;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# sample.bin --cache 32,2,2 --sample 4
+# 	Cache L1 has size 32, associativity 2, blocksize 2, lines 8
+# 	L1 MISS  pc:    3	addr:   32	line:   0
+# 	L1 HIT   pc:    3	addr:   33	line:   0
+# 	L1 MISS  pc:    3	addr:   40	line:   4
+# 	L1 HIT   pc:    3	addr:   41	line:   4
+# 	L1 MISS  pc:    3	addr:   48	line:   0
+# 	L1 HIT   pc:    3	addr:   49	line:   0
+# 	L1 MISS  pc:    3	addr:   56	line:   4
+# 	L1 HIT   pc:    3	addr:   57	line:   4
+# 	L1 MISS  pc:    3	addr:   64	line:   0
+# 	L1 HIT   pc:    3	addr:   65	line:   0
+# 	L1 MISS  pc:    3	addr:   72	line:   4
+# 	L1 HIT   pc:    3	addr:   73	line:   4
+# 	L1 MISS  pc:    3	addr:   80	line:   0
+# 	L1 HIT   pc:    3	addr:   81	line:   0
+# 	L1 MISS  pc:    3	addr:   88	line:   4
+# 	L1 HIT   pc:    3	addr:   89	line:   4
+# 	L1 MISS  pc:    3	addr:   32	line:   0
+# 	L1 HIT   pc:    3	addr:   33	line:   0
+# 	L1 MISS  pc:    3	addr:   40	line:   4
+# 	L1 HIT   pc:    3	addr:   41	line:   4
+# 	L1 MISS  pc:    3	addr:   48	line:   0
+# 	L1 HIT   pc:    3	addr:   49	line:   0
+# 	L1 MISS  pc:    3	addr:   56	line:   4
+# 	L1 HIT   pc:    3	addr:   57	line:   4
+# 	L1 MISS  pc:    3	addr:   64	line:   0
+# 	L1 HIT   pc:    3	addr:   65	line:   0
+# 	L1 MISS  pc:    3	addr:   72	line:   4
+# 	L1 HIT   pc:    3	addr:   73	line:   4
+# 	L1 MISS  pc:    3	addr:   80	line:   0
+# 	L1 HIT   pc:    3	addr:   81	line:   0
+# 	L1 MISS  pc:    3	addr:   88	line:   4
+# 	L1 HIT   pc:    3	addr:   89	line:   4
+# 	Sampled L1 sets 2 of 8, estimated accesses 128, misses 64 +/- 0, miss rate 50.00% +/- 0.00% (95% confidence)
+# 
+# sample.bin --cache 32,2,2 --sample 4 --sample-hash --sample-validate
+# 	Cache L1 has size 32, associativity 2, blocksize 2, lines 8
+# 	L1 MISS  pc:    3	addr:   32	line:   0
+# 	L1 HIT   pc:    3	addr:   33	line:   0
+# 	L1 MISS  pc:    3	addr:   44	line:   6
+# 	L1 HIT   pc:    3	addr:   45	line:   6
+# 	L1 MISS  pc:    3	addr:   46	line:   7
+# 	L1 HIT   pc:    3	addr:   47	line:   7
+# 	L1 MISS  pc:    3	addr:   48	line:   0
+# 	L1 HIT   pc:    3	addr:   49	line:   0
+# 	L1 MISS  pc:    3	addr:   60	line:   6
+# 	L1 HIT   pc:    3	addr:   61	line:   6
+# 	L1 MISS  pc:    3	addr:   62	line:   7
+# 	L1 HIT   pc:    3	addr:   63	line:   7
+# 	L1 MISS  pc:    3	addr:   64	line:   0
+# 	L1 HIT   pc:    3	addr:   65	line:   0
+# 	L1 MISS  pc:    3	addr:   76	line:   6
+# 	L1 HIT   pc:    3	addr:   77	line:   6
+# 	L1 MISS  pc:    3	addr:   78	line:   7
+# 	L1 HIT   pc:    3	addr:   79	line:   7
+# 	L1 MISS  pc:    3	addr:   80	line:   0
+# 	L1 HIT   pc:    3	addr:   81	line:   0
+# 	L1 MISS  pc:    3	addr:   92	line:   6
+# 	L1 HIT   pc:    3	addr:   93	line:   6
+# 	L1 MISS  pc:    3	addr:   94	line:   7
+# 	L1 MISS  pc:    3	addr:   32	line:   0
+# 	L1 HIT   pc:    3	addr:   33	line:   0
+# 	L1 MISS  pc:    3	addr:   44	line:   6
+# 	L1 HIT   pc:    3	addr:   45	line:   6
+# 	L1 MISS  pc:    3	addr:   46	line:   7
+# 	L1 HIT   pc:    3	addr:   47	line:   7
+# 	L1 MISS  pc:    3	addr:   48	line:   0
+# 	L1 HIT   pc:    3	addr:   49	line:   0
+# 	L1 MISS  pc:    3	addr:   60	line:   6
+# 	L1 HIT   pc:    3	addr:   61	line:   6
+# 	L1 MISS  pc:    3	addr:   62	line:   7
+# 	L1 HIT   pc:    3	addr:   63	line:   7
+# 	L1 MISS  pc:    3	addr:   64	line:   0
+# 	L1 HIT   pc:    3	addr:   65	line:   0
+# 	L1 MISS  pc:    3	addr:   76	line:   6
+# 	L1 HIT   pc:    3	addr:   77	line:   6
+# 	L1 MISS  pc:    3	addr:   78	line:   7
+# 	L1 HIT   pc:    3	addr:   79	line:   7
+# 	L1 MISS  pc:    3	addr:   80	line:   0
+# 	L1 HIT   pc:    3	addr:   81	line:   0
+# 	L1 MISS  pc:    3	addr:   92	line:   6
+# 	L1 HIT   pc:    3	addr:   93	line:   6
+# 	L1 MISS  pc:    3	addr:   94	line:   7
+# 	Sampled L1 sets 3 of 8, estimated accesses 122, misses 64 +/- 0, miss rate 52.17% +/- 3.51% (95% confidence)
+# 	Full L1 accesses 126, misses 64, miss rate 50.79%, estimation error 1.38% (inside the confidence interval)
+# 
+# sample.bin --cache 8,1,1,32,2,2 --sample 2
+# 	Cache L1 has size 8, associativity 1, blocksize 1, lines 8
+# 	Cache L2 has size 32, associativity 2, blocksize 2, lines 8
+# 	L1 MISS  pc:    3	addr:   32	line:   0
+# 	L2 MISS  pc:    3	addr:   32	line:   0
+# 	L1 MISS  pc:    3	addr:   33	line:   1
+# 	L2 HIT   pc:    3	addr:   33	line:   0
+# 	L1 MISS  pc:    3	addr:   34	line:   2
+# 	L1 MISS  pc:    3	addr:   35	line:   3
+# 	L1 MISS  pc:    3	addr:   36	line:   4
+# 	L2 MISS  pc:    3	addr:   36	line:   2
+# 	L1 MISS  pc:    3	addr:   37	line:   5
+# 	L2 HIT   pc:    3	addr:   37	line:   2
+# 	L1 MISS  pc:    3	addr:   38	line:   6
+# 	L1 MISS  pc:    3	addr:   39	line:   7
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L2 MISS  pc:    3	addr:   40	line:   4
+# 	L1 MISS  pc:    3	addr:   41	line:   1
+# 	L2 HIT   pc:    3	addr:   41	line:   4
+# 	L1 MISS  pc:    3	addr:   42	line:   2
+# 	L1 MISS  pc:    3	addr:   43	line:   3
+# 	L1 MISS  pc:    3	addr:   44	line:   4
+# 	L2 MISS  pc:    3	addr:   44	line:   6
+# 	L1 MISS  pc:    3	addr:   45	line:   5
+# 	L2 HIT   pc:    3	addr:   45	line:   6
+# 	L1 MISS  pc:    3	addr:   46	line:   6
+# 	L1 MISS  pc:    3	addr:   47	line:   7
+# 	L1 MISS  pc:    3	addr:   48	line:   0
+# 	L2 MISS  pc:    3	addr:   48	line:   0
+# 	L1 MISS  pc:    3	addr:   49	line:   1
+# 	L2 HIT   pc:    3	addr:   49	line:   0
+# 	L1 MISS  pc:    3	addr:   50	line:   2
+# 	L1 MISS  pc:    3	addr:   51	line:   3
+# 	L1 MISS  pc:    3	addr:   52	line:   4
+# 	L2 MISS  pc:    3	addr:   52	line:   2
+# 	L1 MISS  pc:    3	addr:   53	line:   5
+# 	L2 HIT   pc:    3	addr:   53	line:   2
+# 	L1 MISS  pc:    3	addr:   54	line:   6
+# 	L1 MISS  pc:    3	addr:   55	line:   7
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L2 MISS  pc:    3	addr:   56	line:   4
+# 	L1 MISS  pc:    3	addr:   57	line:   1
+# 	L2 HIT   pc:    3	addr:   57	line:   4
+# 	L1 MISS  pc:    3	addr:   58	line:   2
+# 	L1 MISS  pc:    3	addr:   59	line:   3
+# 	L1 MISS  pc:    3	addr:   60	line:   4
+# 	L2 MISS  pc:    3	addr:   60	line:   6
+# 	L1 MISS  pc:    3	addr:   61	line:   5
+# 	L2 HIT   pc:    3	addr:   61	line:   6
+# 	L1 MISS  pc:    3	addr:   62	line:   6
+# 	L1 MISS  pc:    3	addr:   63	line:   7
+# 	L1 MISS  pc:    3	addr:   64	line:   0
+# 	L2 MISS  pc:    3	addr:   64	line:   0
+# 	L1 MISS  pc:    3	addr:   65	line:   1
+# 	L2 HIT   pc:    3	addr:   65	line:   0
+# 	L1 MISS  pc:    3	addr:   66	line:   2
+# 	L1 MISS  pc:    3	addr:   67	line:   3
+# 	L1 MISS  pc:    3	addr:   68	line:   4
+# 	L2 MISS  pc:    3	addr:   68	line:   2
+# 	L1 MISS  pc:    3	addr:   69	line:   5
+# 	L2 HIT   pc:    3	addr:   69	line:   2
+# 	L1 MISS  pc:    3	addr:   70	line:   6
+# 	L1 MISS  pc:    3	addr:   71	line:   7
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	L2 MISS  pc:    3	addr:   72	line:   4
+# 	L1 MISS  pc:    3	addr:   73	line:   1
+# 	L2 HIT   pc:    3	addr:   73	line:   4
+# 	L1 MISS  pc:    3	addr:   74	line:   2
+# 	L1 MISS  pc:    3	addr:   75	line:   3
+# 	L1 MISS  pc:    3	addr:   76	line:   4
+# 	L2 MISS  pc:    3	addr:   76	line:   6
+# 	L1 MISS  pc:    3	addr:   77	line:   5
+# 	L2 HIT   pc:    3	addr:   77	line:   6
+# 	L1 MISS  pc:    3	addr:   78	line:   6
+# 	L1 MISS  pc:    3	addr:   79	line:   7
+# 	L1 MISS  pc:    3	addr:   80	line:   0
+# 	L2 MISS  pc:    3	addr:   80	line:   0
+# 	L1 MISS  pc:    3	addr:   81	line:   1
+# 	L2 HIT   pc:    3	addr:   81	line:   0
+# 	L1 MISS  pc:    3	addr:   82	line:   2
+# 	L1 MISS  pc:    3	addr:   83	line:   3
+# 	L1 MISS  pc:    3	addr:   84	line:   4
+# 	L2 MISS  pc:    3	addr:   84	line:   2
+# 	L1 MISS  pc:    3	addr:   85	line:   5
+# 	L2 HIT   pc:    3	addr:   85	line:   2
+# 	L1 MISS  pc:    3	addr:   86	line:   6
+# 	L1 MISS  pc:    3	addr:   87	line:   7
+# 	L1 MISS  pc:    3	addr:   88	line:   0
+# 	L2 MISS  pc:    3	addr:   88	line:   4
+# 	L1 MISS  pc:    3	addr:   89	line:   1
+# 	L2 HIT   pc:    3	addr:   89	line:   4
+# 	L1 MISS  pc:    3	addr:   90	line:   2
+# 	L1 MISS  pc:    3	addr:   91	line:   3
+# 	L1 MISS  pc:    3	addr:   92	line:   4
+# 	L2 MISS  pc:    3	addr:   92	line:   6
+# 	L1 MISS  pc:    3	addr:   93	line:   5
+# 	L2 HIT   pc:    3	addr:   93	line:   6
+# 	L1 MISS  pc:    3	addr:   94	line:   6
+# 	L1 MISS  pc:    3	addr:   32	line:   0
+# 	L2 MISS  pc:    3	addr:   32	line:   0
+# 	L1 MISS  pc:    3	addr:   33	line:   1
+# 	L2 HIT   pc:    3	addr:   33	line:   0
+# 	L1 MISS  pc:    3	addr:   34	line:   2
+# 	L1 MISS  pc:    3	addr:   35	line:   3
+# 	L1 MISS  pc:    3	addr:   36	line:   4
+# 	L2 MISS  pc:    3	addr:   36	line:   2
+# 	L1 MISS  pc:    3	addr:   37	line:   5
+# 	L2 HIT   pc:    3	addr:   37	line:   2
+# 	L1 MISS  pc:    3	addr:   38	line:   6
+# 	L1 MISS  pc:    3	addr:   39	line:   7
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L2 MISS  pc:    3	addr:   40	line:   4
+# 	L1 MISS  pc:    3	addr:   41	line:   1
+# 	L2 HIT   pc:    3	addr:   41	line:   4
+# 	L1 MISS  pc:    3	addr:   42	line:   2
+# 	L1 MISS  pc:    3	addr:   43	line:   3
+# 	L1 MISS  pc:    3	addr:   44	line:   4
+# 	L2 MISS  pc:    3	addr:   44	line:   6
+# 	L1 MISS  pc:    3	addr:   45	line:   5
+# 	L2 HIT   pc:    3	addr:   45	line:   6
+# 	L1 MISS  pc:    3	addr:   46	line:   6
+# 	L1 MISS  pc:    3	addr:   47	line:   7
+# 	L1 MISS  pc:    3	addr:   48	line:   0
+# 	L2 MISS  pc:    3	addr:   48	line:   0
+# 	L1 MISS  pc:    3	addr:   49	line:   1
+# 	L2 HIT   pc:    3	addr:   49	line:   0
+# 	L1 MISS  pc:    3	addr:   50	line:   2
+# 	L1 MISS  pc:    3	addr:   51	line:   3
+# 	L1 MISS  pc:    3	addr:   52	line:   4
+# 	L2 MISS  pc:    3	addr:   52	line:   2
+# 	L1 MISS  pc:    3	addr:   53	line:   5
+# 	L2 HIT   pc:    3	addr:   53	line:   2
+# 	L1 MISS  pc:    3	addr:   54	line:   6
+# 	L1 MISS  pc:    3	addr:   55	line:   7
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L2 MISS  pc:    3	addr:   56	line:   4
+# 	L1 MISS  pc:    3	addr:   57	line:   1
+# 	L2 HIT   pc:    3	addr:   57	line:   4
+# 	L1 MISS  pc:    3	addr:   58	line:   2
+# 	L1 MISS  pc:    3	addr:   59	line:   3
+# 	L1 MISS  pc:    3	addr:   60	line:   4
+# 	L2 MISS  pc:    3	addr:   60	line:   6
+# 	L1 MISS  pc:    3	addr:   61	line:   5
+# 	L2 HIT   pc:    3	addr:   61	line:   6
+# 	L1 MISS  pc:    3	addr:   62	line:   6
+# 	L1 MISS  pc:    3	addr:   63	line:   7
+# 	L1 MISS  pc:    3	addr:   64	line:   0
+# 	L2 MISS  pc:    3	addr:   64	line:   0
+# 	L1 MISS  pc:    3	addr:   65	line:   1
+# 	L2 HIT   pc:    3	addr:   65	line:   0
+# 	L1 MISS  pc:    3	addr:   66	line:   2
+# 	L1 MISS  pc:    3	addr:   67	line:   3
+# 	L1 MISS  pc:    3	addr:   68	line:   4
+# 	L2 MISS  pc:    3	addr:   68	line:   2
+# 	L1 MISS  pc:    3	addr:   69	line:   5
+# 	L2 HIT   pc:    3	addr:   69	line:   2
+# 	L1 MISS  pc:    3	addr:   70	line:   6
+# 	L1 MISS  pc:    3	addr:   71	line:   7
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	L2 MISS  pc:    3	addr:   72	line:   4
+# 	L1 MISS  pc:    3	addr:   73	line:   1
+# 	L2 HIT   pc:    3	addr:   73	line:   4
+# 	L1 MISS  pc:    3	addr:   74	line:   2
+# 	L1 MISS  pc:    3	addr:   75	line:   3
+# 	L1 MISS  pc:    3	addr:   76	line:   4
+# 	L2 MISS  pc:    3	addr:   76	line:   6
+# 	L1 MISS  pc:    3	addr:   77	line:   5
+# 	L2 HIT   pc:    3	addr:   77	line:   6
+# 	L1 MISS  pc:    3	addr:   78	line:   6
+# 	L1 MISS  pc:    3	addr:   79	line:   7
+# 	L1 MISS  pc:    3	addr:   80	line:   0
+# 	L2 MISS  pc:    3	addr:   80	line:   0
+# 	L1 MISS  pc:    3	addr:   81	line:   1
+# 	L2 HIT   pc:    3	addr:   81	line:   0
+# 	L1 MISS  pc:    3	addr:   82	line:   2
+# 	L1 MISS  pc:    3	addr:   83	line:   3
+# 	L1 MISS  pc:    3	addr:   84	line:   4
+# 	L2 MISS  pc:    3	addr:   84	line:   2
+# 	L1 MISS  pc:    3	addr:   85	line:   5
+# 	L2 HIT   pc:    3	addr:   85	line:   2
+# 	L1 MISS  pc:    3	addr:   86	line:   6
+# 	L1 MISS  pc:    3	addr:   87	line:   7
+# 	L1 MISS  pc:    3	addr:   88	line:   0
+# 	L2 MISS  pc:    3	addr:   88	line:   4
+# 	L1 MISS  pc:    3	addr:   89	line:   1
+# 	L2 HIT   pc:    3	addr:   89	line:   4
+# 	L1 MISS  pc:    3	addr:   90	line:   2
+# 	L1 MISS  pc:    3	addr:   91	line:   3
+# 	L1 MISS  pc:    3	addr:   92	line:   4
+# 	L2 MISS  pc:    3	addr:   92	line:   6
+# 	L1 MISS  pc:    3	addr:   93	line:   5
+# 	L2 HIT   pc:    3	addr:   93	line:   6
+# 	L1 MISS  pc:    3	addr:   94	line:   6
+# 	Sampled L2 sets 4 of 8, estimated accesses 128, misses 64 +/- 0, miss rate 50.00% +/- 0.00% (95% confidence)
+# 
+# sample.bin --cache 32,2,2 --sample 4 --timing 1,10,100
+# 	Cache L1 has size 32, associativity 2, blocksize 2, lines 8
+# 	Set sampling estimates the miss rate of the last shared cache only, without timing
+# 
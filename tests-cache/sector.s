@@ -0,0 +1,63 @@
+# We're testing sectored caches, with blocks of 8 cells in sectors of 2.
+# The first load brings in one sector only, so the load of another
+# sector of the same block hits the tag but misses its sector. The
+# stores dirty two sectors of cache 2, which are written back on their
+# own when a later block evicts theirs. In a single cache the stores
+# dirty cache 1 instead.
+
+    lw $1, 16($0)           # miss, sector 0
+    lw $2, 17($0)           # hit, same sector
+    lw $3, 20($0)           # tag hit, sector miss
+    sw $3, 18($0)           # dirties sector 1
+    sw $3, 22($0)           # dirties sector 3
+    lw $4, 48($0)
+    lw $5, 32($0)           # evicts the dirty block
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b1000000010010000;		// lw $1,16($0)
+# ram[1] = 16'b1000000100010001;		// lw $2,17($0)
+# ram[2] = 16'b1000000110010100;		// lw $3,20($0)
+# ram[3] = 16'b1010000110010010;		// sw $3,18($0)
+# ram[4] = 16'b1010000110010110;		// sw $3,22($0)
+# ram[5] = 16'b1000001000110000;		// lw $4,48($0)
+# ram[6] = 16'b1000001010100000;		// lw $5,32($0)
+# ram[7] = 16'b0100000000000111;		// halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# sector.bin --cache 16,2,8 --sector 2
+# 	Cache L1 has size 16, associativity 2, blocksize 8, lines 1
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L1 HIT   pc:    1	addr:   17	line:   0
+# 	L1 MISS  pc:    2	addr:   20	line:   0
+# 	L1 SW    pc:    3	addr:   18	line:   0
+# 	L1 SW    pc:    4	addr:   22	line:   0
+# 	L1 MISS  pc:    5	addr:   48	line:   0
+# 	L1 MISS  pc:    6	addr:   32	line:   0
+# 	Sectors L1 size 2, tag hits 4, sector misses 3, cells fetched 12 (whole blocks 24), dirty sector writebacks 2
+# 
+# sector.bin --cache 16,2,8,32,2,8 --sector 4,2
+# 	Cache L1 has size 16, associativity 2, blocksize 8, lines 1
+# 	Cache L2 has size 32, associativity 2, blocksize 8, lines 2
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L2 MISS  pc:    0	addr:   16	line:   0
+# 	L1 HIT   pc:    1	addr:   17	line:   0
+# 	L1 MISS  pc:    2	addr:   20	line:   0
+# 	L2 MISS  pc:    2	addr:   20	line:   0
+# 	L1 SW    pc:    3	addr:   18	line:   0
+# 	L2 SW    pc:    3	addr:   18	line:   0
+# 	L1 SW    pc:    4	addr:   22	line:   0
+# 	L2 SW    pc:    4	addr:   22	line:   0
+# 	L1 MISS  pc:    5	addr:   48	line:   0
+# 	L2 MISS  pc:    5	addr:   48	line:   0
+# 	L1 MISS  pc:    6	addr:   32	line:   0
+# 	L2 MISS  pc:    6	addr:   32	line:   0
+# 	Sectors L1 size 4, tag hits 4, sector misses 1, cells fetched 16 (whole blocks 24), dirty sector writebacks 0
+# 	Sectors L2 size 2, tag hits 3, sector misses 3, cells fetched 12 (whole blocks 24), dirty sector writebacks 2
+# 
+# sector.bin --cache 16,2,8 --sector 3
+# 	Cache L1 has size 16, associativity 2, blocksize 8, lines 1
+# 	Invalid sector config
+# 
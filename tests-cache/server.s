@@ -0,0 +1,64 @@
+# We're testing the simulation server. Jobs sent with --client print
+# what the same run prints on the command line, with its exit status.
+# A job with a bad cache config fails on its own, and the server keeps
+# running the jobs that follow it.
+
+    movi $1, 4
+loop:
+    lw $2, 20($1)
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000100;		// movi $1,4
+# ram[1] = 16'b1000010100010100;		// loop: lw $2,20($1)
+# ram[2] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[3] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[4] = 16'b0100000000000001;		// j loop
+# ram[5] = 16'b0100000000000101;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# simcache --serve $TMP/other.sock --workers two 2> /dev/null; echo "exit $?"
+# 	exit 1
+# 
+# simcache --client $SOCKET --cache 32,0,4 server.bin; echo "exit $?"
+# 	Invalid cache config
+# 	exit 1
+# 
+# simcache --client $SOCKET --cache 16,x,2 server.bin; echo "exit $?"
+# 	Invalid number in the arguments
+# 	exit 1
+# 
+# simcache --client $SOCKET --cache 16,2,2 server.bin; echo "exit $?"
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   24	line:   0
+# 	L1 MISS  pc:    1	addr:   23	line:   3
+# 	L1 HIT   pc:    1	addr:   22	line:   3
+# 	L1 MISS  pc:    1	addr:   21	line:   2
+# 	exit 0
+# 
+# --client $SOCKET --send-image --cache 4,1,1,16,2,2 server.bin
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	Cache L2 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   24	line:   0
+# 	L2 MISS  pc:    1	addr:   24	line:   0
+# 	L1 MISS  pc:    1	addr:   23	line:   3
+# 	L2 MISS  pc:    1	addr:   23	line:   3
+# 	L1 MISS  pc:    1	addr:   22	line:   2
+# 	L2 HIT   pc:    1	addr:   22	line:   3
+# 	L1 MISS  pc:    1	addr:   21	line:   1
+# 	L2 MISS  pc:    1	addr:   21	line:   2
+# 
+# simcache --client $SOCKET --batch < <(printf -- '--cache 16,4,0 server.bin\n--cache 8,1,2 server.bin\n')
+# 	Invalid cache config
+# 	Cache L1 has size 8, associativity 1, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   24	line:   0
+# 	L1 MISS  pc:    1	addr:   23	line:   3
+# 	L1 HIT   pc:    1	addr:   22	line:   3
+# 	L1 MISS  pc:    1	addr:   21	line:   2
+# 
@@ -0,0 +1,86 @@
+# We're testing timing. The four loads miss in four different blocks of
+# cache 1, two blocks of cache 2, and don't depend on each other. With
+# miss status holding registers (--mshr) their misses overlap and the core
+# only stalls at the first add. The loads of 18 and 22 hit cache 2 on a
+# block still coming from memory, so they merge into its register and
+# wait for it. With a single register per cache the misses are served one
+# at a time. With blocking caches every miss stalls the core on its own.
+
+    lw $1, 16($0)
+    lw $2, 18($0)
+    lw $3, 20($0)
+    lw $4, 22($0)
+    add $5, $1, $2          # waits for the first two loads
+    add $5, $5, $3
+    add $5, $5, $4
+    lw $6, 17($0)           # a hit in the block of the first load
+    sw $5, 48($0)
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b1000000010010000;		// lw $1,16($0)
+# ram[1] = 16'b1000000100010010;		// lw $2,18($0)
+# ram[2] = 16'b1000000110010100;		// lw $3,20($0)
+# ram[3] = 16'b1000001000010110;		// lw $4,22($0)
+# ram[4] = 16'b0000010101010000;		// add $5,$1,$2
+# ram[5] = 16'b0001010111010000;		// add $5,$5,$3
+# ram[6] = 16'b0001011001010000;		// add $5,$5,$4
+# ram[7] = 16'b1000001100010001;		// lw $6,17($0)
+# ram[8] = 16'b1010001010110000;		// sw $5,48($0)
+# ram[9] = 16'b0100000000001001;		// halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# timing.bin --cache 16,2,2,64,2,4 --timing 1,10,100
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	Cache L2 has size 64, associativity 2, blocksize 4, lines 8
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L2 MISS  pc:    0	addr:   16	line:   4
+# 	L1 MISS  pc:    1	addr:   18	line:   1
+# 	L2 HIT   pc:    1	addr:   18	line:   4
+# 	L1 MISS  pc:    2	addr:   20	line:   2
+# 	L2 MISS  pc:    2	addr:   20	line:   5
+# 	L1 MISS  pc:    3	addr:   22	line:   3
+# 	L2 HIT   pc:    3	addr:   22	line:   5
+# 	L1 HIT   pc:    7	addr:   17	line:   0
+# 	L1 SW    pc:    8	addr:   48	line:   0
+# 	L2 SW    pc:    8	addr:   48	line:   4
+# 	Timing cycles 254, instructions 10, CPI 25.40, load-use stall cycles 0, miss stall cycles 244
+# 
+# timing.bin --cache 16,2,2,64,2,4 --mshr 4,4
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	Cache L2 has size 64, associativity 2, blocksize 4, lines 8
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L2 MISS  pc:    0	addr:   16	line:   4
+# 	L1 MISS  pc:    1	addr:   18	line:   1
+# 	L2 HIT   pc:    1	addr:   18	line:   4
+# 	L1 MISS  pc:    2	addr:   20	line:   2
+# 	L2 MISS  pc:    2	addr:   20	line:   5
+# 	L1 MISS  pc:    3	addr:   22	line:   3
+# 	L2 HIT   pc:    3	addr:   22	line:   5
+# 	L1 HIT   pc:    7	addr:   17	line:   0
+# 	L1 SW    pc:    8	addr:   48	line:   0
+# 	L2 SW    pc:    8	addr:   48	line:   4
+# 	Timing cycles 118, instructions 10, CPI 11.80, load-use stall cycles 108, miss stall cycles 0
+# 	MSHR L1 registers 4, primary misses 4, merges 0, full stall cycles 0, average occupancy 3.75, peak occupancy 4
+# 	MSHR L2 registers 4, primary misses 2, merges 2, full stall cycles 0, average occupancy 1.88, peak occupancy 2
+# 
+# timing.bin --cache 16,2,2,64,2,4 --mshr 1,1
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	Cache L2 has size 64, associativity 2, blocksize 4, lines 8
+# 	L1 MISS  pc:    0	addr:   16	line:   0
+# 	L2 MISS  pc:    0	addr:   16	line:   4
+# 	L1 MISS  pc:    1	addr:   18	line:   1
+# 	L2 HIT   pc:    1	addr:   18	line:   4
+# 	L1 MISS  pc:    2	addr:   20	line:   2
+# 	L2 MISS  pc:    2	addr:   20	line:   5
+# 	L1 MISS  pc:    3	addr:   22	line:   3
+# 	L2 HIT   pc:    3	addr:   22	line:   5
+# 	L1 HIT   pc:    7	addr:   17	line:   0
+# 	L1 SW    pc:    8	addr:   48	line:   0
+# 	L2 SW    pc:    8	addr:   48	line:   4
+# 	Timing cycles 248, instructions 10, CPI 24.80, load-use stall cycles 8, miss stall cycles 0
+# 	MSHR L1 registers 1, primary misses 4, merges 0, full stall cycles 230, average occupancy 0.98, peak occupancy 1
+# 	MSHR L2 registers 1, primary misses 2, merges 0, full stall cycles 0, average occupancy 0.90, peak occupancy 1
+# 
@@ -0,0 +1,120 @@
+# We're testing address translation. The loop loads from four pages of
+# 16 cells, twice. Two L1 TLB entries can't hold all four pages, so the
+# second pass misses in the L1 TLB again, while an L2 TLB keeps them all.
+# Pages get frames in the order they are first touched, and page walks
+# read the page table through the data caches.
+
+    movi $4, 2              # passes
+outer:
+    movi $1, 4              # pages
+    movi $3, 0
+loop:
+    lw $2, 40($3)
+    addi $3, $3, 16         # the next page
+    addi $1, $1, -1
+    jeq $1, $0, next
+    j loop
+next:
+    addi $4, $4, -1
+    jeq $4, $0, done
+    j outer
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010001000000010;		// movi $4,2
+# ram[1] = 16'b0010000010000100;		// outer: movi $1,4
+# ram[2] = 16'b0010000110000000;		// movi $3,0
+# ram[3] = 16'b1000110100101000;		// loop: lw $2,40($3)
+# ram[4] = 16'b0010110110010000;		// addi $3,$3,16
+# ram[5] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[6] = 16'b1100010000000001;		// jeq $1,$0,next
+# ram[7] = 16'b0100000000000011;		// j loop
+# ram[8] = 16'b0011001001111111;		// next: addi $4,$4,-1
+# ram[9] = 16'b1101000000000001;		// jeq $4,$0,done
+# ram[10] = 16'b0100000000000001;		// j outer
+# ram[11] = 16'b0100000000001011;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# tlb.bin --cache 16,2,2 --tlb 16,2,1
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 WMISS pc:    3	addr:    2	line:   1
+# 	L1 MISS  pc:    3	addr:   24	line:   0
+# 	L1 WHIT  pc:    3	addr:    3	line:   1
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L1 WMISS pc:    3	addr:    4	line:   2
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L1 WHIT  pc:    3	addr:    5	line:   2
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	L1 WHIT  pc:    3	addr:    2	line:   1
+# 	L1 MISS  pc:    3	addr:   24	line:   0
+# 	L1 WHIT  pc:    3	addr:    3	line:   1
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L1 WHIT  pc:    3	addr:    4	line:   2
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L1 WHIT  pc:    3	addr:    5	line:   2
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	TLB L1 accesses 8, hits 0, misses 8, hit rate 0.00%
+# 	Page walks 8, entries read from L1 6, L2 0, memory 2
+# 	Pages mapped 4, page table pages 1
+# 
+# tlb.bin --cache 16,2,2,64,4,4 --tlb 16,2,1,8,0 --timing 1,10,100
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	Cache L2 has size 64, associativity 4, blocksize 4, lines 4
+# 	L1 WMISS pc:    3	addr:    2	line:   1
+# 	L2 WMISS pc:    3	addr:    2	line:   0
+# 	L1 MISS  pc:    3	addr:   24	line:   0
+# 	L2 MISS  pc:    3	addr:   24	line:   2
+# 	L1 WHIT  pc:    3	addr:    3	line:   1
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L2 MISS  pc:    3	addr:   40	line:   2
+# 	L1 WMISS pc:    3	addr:    4	line:   2
+# 	L2 WMISS pc:    3	addr:    4	line:   1
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L2 MISS  pc:    3	addr:   56	line:   2
+# 	L1 WHIT  pc:    3	addr:    5	line:   2
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	L2 MISS  pc:    3	addr:   72	line:   2
+# 	L1 MISS  pc:    3	addr:   24	line:   0
+# 	L2 HIT   pc:    3	addr:   24	line:   2
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L2 HIT   pc:    3	addr:   40	line:   2
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L2 HIT   pc:    3	addr:   56	line:   2
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	L2 HIT   pc:    3	addr:   72	line:   2
+# 	Timing cycles 773, instructions 49, CPI 15.78, load-use stall cycles 0, miss stall cycles 488
+# 	TLB L1 accesses 8, hits 0, misses 8, hit rate 0.00%
+# 	TLB L2 accesses 8, hits 4, misses 4, hit rate 50.00%
+# 	Page walks 4, entries read from L1 2, L2 0, memory 2, translation stall cycles 236
+# 	Pages mapped 4, page table pages 1
+# 
+# tlb.bin --cache 16,2,2 --tlb 16,2,1 --vipt --timing 1,10,100
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 WMISS pc:    3	addr:    2	line:   1
+# 	L1 MISS  pc:    3	addr:   24	line:   0
+# 	L1 WHIT  pc:    3	addr:    3	line:   1
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L1 WMISS pc:    3	addr:    4	line:   2
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L1 WHIT  pc:    3	addr:    5	line:   2
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	L1 WHIT  pc:    3	addr:    2	line:   1
+# 	L1 MISS  pc:    3	addr:   24	line:   0
+# 	L1 WHIT  pc:    3	addr:    3	line:   1
+# 	L1 MISS  pc:    3	addr:   40	line:   0
+# 	L1 WHIT  pc:    3	addr:    4	line:   2
+# 	L1 MISS  pc:    3	addr:   56	line:   0
+# 	L1 WHIT  pc:    3	addr:    5	line:   2
+# 	L1 MISS  pc:    3	addr:   72	line:   0
+# 	Timing cycles 1065, instructions 49, CPI 21.73, load-use stall cycles 0, miss stall cycles 808
+# 	TLB L1 accesses 8, hits 0, misses 8, hit rate 0.00%
+# 	Page walks 8, entries read from L1 6, L2 0, memory 2, translation stall cycles 208
+# 	Pages mapped 4, page table pages 1
+# 
+# tlb.bin --cache 32,1,2 --tlb 16,2,1 --vipt
+# 	Cache L1 has size 32, associativity 1, blocksize 2, lines 16
+# 	Cache 1 can't be virtually indexed: its sets times its blocksize exceed the page size
+# 
@@ -0,0 +1,76 @@
+# We're testing way prediction. The two loads alternate between two
+# blocks of the same set, so after the first pass both always hit. The
+# most recently used block of the set is always the other one, so MRU
+# prediction misses every time, while the pc predictor finds the block
+# each load touched on its last run.
+
+    movi $1, 4              # iterations
+loop:
+    lw $2, 16($0)           # set 0
+    lw $3, 24($0)           # set 0, another tag
+    addi $1, $1, -1
+    jeq $1, $0, done
+    j loop
+done:
+    halt
+#--
+#--
+#--MACHINE CODE
+# ram[0] = 16'b0010000010000100;		// movi $1,4
+# ram[1] = 16'b1000000100010000;		// loop: lw $2,16($0)
+# ram[2] = 16'b1000000110011000;		// lw $3,24($0)
+# ram[3] = 16'b0010010011111111;		// addi $1,$1,-1
+# ram[4] = 16'b1100010000000001;		// jeq $1,$0,done
+# ram[5] = 16'b0100000000000001;		// j loop
+# ram[6] = 16'b0100000000000110;		// done: halt 
+#--
+#--
+#--EXECUTION OUTPUT
+# way-predict.bin --cache 16,2,2 --way-predict mru
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   16	line:   0
+# 	L1 MISS  pc:    2	addr:   24	line:   0
+# 	L1 HIT   pc:    1	addr:   16	line:   0
+# 	L1 HIT   pc:    2	addr:   24	line:   0
+# 	L1 HIT   pc:    1	addr:   16	line:   0
+# 	L1 HIT   pc:    2	addr:   24	line:   0
+# 	L1 HIT   pc:    1	addr:   16	line:   0
+# 	L1 HIT   pc:    2	addr:   24	line:   0
+# 	Way prediction L1 (mru) hits 6, first probe 0, second probe 6, misses 2, accuracy 0.00%
+# 
+# way-predict.bin --cache 16,2,2 --way-predict pc
+# 	Cache L1 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   16	line:   0
+# 	L1 MISS  pc:    2	addr:   24	line:   0
+# 	L1 HIT   pc:    1	addr:   16	line:   0
+# 	L1 HIT   pc:    2	addr:   24	line:   0
+# 	L1 HIT   pc:    1	addr:   16	line:   0
+# 	L1 HIT   pc:    2	addr:   24	line:   0
+# 	L1 HIT   pc:    1	addr:   16	line:   0
+# 	L1 HIT   pc:    2	addr:   24	line:   0
+# 	Way prediction L1 (pc) hits 6, first probe 6, second probe 0, misses 2, accuracy 100.00%
+# 
+# way-predict.bin --cache 4,1,1,16,2,2 --way-predict pc
+# 	Cache L1 has size 4, associativity 1, blocksize 1, lines 4
+# 	Cache L2 has size 16, associativity 2, blocksize 2, lines 4
+# 	L1 MISS  pc:    1	addr:   16	line:   0
+# 	L2 MISS  pc:    1	addr:   16	line:   0
+# 	L1 MISS  pc:    2	addr:   24	line:   0
+# 	L2 MISS  pc:    2	addr:   24	line:   0
+# 	L1 MISS  pc:    1	addr:   16	line:   0
+# 	L2 HIT   pc:    1	addr:   16	line:   0
+# 	L1 MISS  pc:    2	addr:   24	line:   0
+# 	L2 HIT   pc:    2	addr:   24	line:   0
+# 	L1 MISS  pc:    1	addr:   16	line:   0
+# 	L2 HIT   pc:    1	addr:   16	line:   0
+# 	L1 MISS  pc:    2	addr:   24	line:   0
+# 	L2 HIT   pc:    2	addr:   24	line:   0
+# 	L1 MISS  pc:    1	addr:   16	line:   0
+# 	L2 HIT   pc:    1	addr:   16	line:   0
+# 	L1 MISS  pc:    2	addr:   24	line:   0
+# 	L2 HIT   pc:    2	addr:   24	line:   0
+# 	Way prediction L2 (pc) hits 6, first probe 6, second probe 0, misses 2, accuracy 100.00%
+# 
+# simcache --cache 16,2,2 --way-predict lru way-predict.bin 2> /dev/null; echo "exit $?"
+# 	exit 1
+# 